@@ -14,6 +14,22 @@ static inline uint32_t pop_32(uint32_t x) { return (uint32_t)__builtin_popcount(
 static inline uint32_t bit_run_count_32(uint32_t x) { return pop_32(x & (x^(x>>1))); }
 static inline uint32_t bit_run_count_64(uint64_t x) { return pop_64(x & (x^(x>>1))); }
 
+// in-place transpose of four independent 64x64 bit matrices (one per lane).
+// on exit: bit 'c' of a[r] is bit 'r' of the input a[c]. So after transposing
+// 64 samples the popcount of a[j] is the number of samples with bit 'j' set.
+static inline void bit_transpose_64x4(u64x4_t a[static 64])
+{
+  uint64_t m = UINT64_C(0x00000000ffffffff);
+
+  for (uint32_t j=32; j!=0; j>>=1, m ^= m << j) {
+    for (uint32_t k=0; k<64; k = ((k|j)+1) & ~j) {
+      u64x4_t t = ((a[k] >> j) ^ a[k|j]) & m;
+      a[k|j] ^= t;
+      a[k]   ^= t << j;
+    }
+  }
+}
+
 static inline void printb(uint64_t v, uint32_t b)
 {
   uint64_t m = UINT64_C(1)<<(b-1);
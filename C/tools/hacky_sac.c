@@ -10,8 +10,15 @@
 #include <fcntl.h>
 #include <time.h>
 #include <getopt.h>
+#include <pthread.h>
 
+#define VPRNG_IMPLEMENTATION
+#ifndef VPRNG_INCLUDE
 #include "vprng.h"
+#else
+#include VPRNG_INCLUDE
+#endif
+
 #include "common.h"
 
 typedef struct {
@@ -463,17 +470,394 @@ uint64_t hash1(uint64_t x) { return hack_hash(x,1); }
 uint64_t hash2(uint64_t x) { return hack_hash(x,2); }
 uint64_t hash3(uint64_t x) { return hack_hash(x,3); }
 
-int main(void)
+//------------------------------------------------
+// Higher order avalanche measures of the 4 lanes of a vprng_mix
+// style finalizer (each lane is measured independently):
+//
+// * BIC (bit independence criterion): for each input bit flip 'i'
+//   and output bit pair (j,k) the correlation of the flips of
+//   output bits 'j' and 'k'.
+// * SAC2: strict avalanche of flipping input bit pairs (i,i')
+//
+// First order SAC can look fine while either of these shows defects.
+// Counting uses the same trick as 'search': the deltas of 64 samples
+// are bit transposed so row 'j' holds output bit 'j' of all samples
+// and then everything is a popcount. Samples are split across threads
+// with each having private tables which are summed at the end.
+
+typedef uint32_t u32x4_t __attribute__ ((vector_size(16)));
+
+typedef u64x4_t (*mix_func_t)(u64x4_t);
+
+enum { HOSAC_BIC = 1, HOSAC_SAC2 = 2, HOSAC_SAC = 4 };
+
+typedef struct {
+  u32x4_t  sac[64][64];        // [flip i][out j]         : flips of j
+  u32x4_t  bic[64][64][64];    // [flip i][out j][out k]  : flips of both j & k (j<k)
+  u32x4_t  sac2[64][64][64];   // [flip i][flip i'][out j] : flips of j (i<i')
+  uint64_t n;                  // samples per lane
+} hosac_t;
+
+static const uint64_t hosac_inc = UINT64_C(0x9e3779b97f4a7c15);
+
+static inline u32x4_t hosac_pop(u64x4_t x)
 {
-  //sac_64_t s = {0};
-  //sac_add(&s, hash, 0xffff);
+  return __builtin_convertvector(vprng_pop_u64x4(x), u32x4_t);
+}
+
+// gather counts for 64 samples per lane: x = inc*(base + 4b + lane)
+static void hosac_batch(hosac_t* s, mix_func_t f, uint64_t base, uint32_t tests)
+{
+  u64x4_t x[64];
+  u64x4_t h[64];
+  u64x4_t t[64];
+
+  for(uint32_t b=0; b<64; b++) {
+    x[b] = ((u64x4_t){0,1,2,3} + (base+4*b)) * hosac_inc;
+    h[b] = f(x[b]);
+  }
+
+  if (tests & (HOSAC_BIC|HOSAC_SAC)) {
+    for(uint32_t i=0; i<64; i++) {
+      uint64_t bi = UINT64_C(1) << i;
+      
+      for(uint32_t b=0; b<64; b++) t[b] = h[b] ^ f(x[b] ^ bi);
 
-  dumb_vle_sac("v0.0.1_0",  hash0);
-  dumb_vle_sac("v0.0.1_1",  hash1);
-  dumb_vle_sac("v0.0.1_2",  hash2);
-  dumb_vle_sac("v0.0.1_3",  hash3);
+      bit_transpose_64x4(t);
+
+      for(uint32_t j=0; j<64; j++) {
+	u64x4_t tj = t[j];
+	
+	s->sac[i][j] += hosac_pop(tj);
+
+	if (!(tests & HOSAC_BIC)) continue;
+
+	for(uint32_t k=j+1; k<64; k++)
+	  s->bic[i][j][k] += hosac_pop(tj & t[k]);
+      }
+    }
+  }
+
+  if (tests & HOSAC_SAC2) {
+    for(uint32_t i0=0; i0<64; i0++) {
+      for(uint32_t i1=i0+1; i1<64; i1++) {
+	uint64_t bi = (UINT64_C(1) << i0) ^ (UINT64_C(1) << i1);
+
+	for(uint32_t b=0; b<64; b++) t[b] = h[b] ^ f(x[b] ^ bi);
+	
+	bit_transpose_64x4(t);
+	
+	for(uint32_t j=0; j<64; j++)
+	  s->sac2[i0][i1][j] += hosac_pop(t[j]);
+      }
+    }
+  }
 
+  s->n += 64;
+}
+
+typedef struct {
+  pthread_t  thread;
+  hosac_t*   s;
+  mix_func_t f;
+  uint64_t   base;      // first sample
+  uint64_t   blocks;    // number of 256 sample blocks
+  uint32_t   tests;
+  bool       started;   // has a thread (otherwise run inline)
+} hosac_job_t;
+
+static void* hosac_worker(void* arg)
+{
+  hosac_job_t* job = (hosac_job_t*)arg;
+
+  for(uint64_t i=0; i<job->blocks; i++)
+    hosac_batch(job->s, job->f, job->base + 256*i, job->tests);
+  
   return 0;
 }
 
+static hosac_t* hosac_alloc(void)
+{
+  hosac_t* s = aligned_alloc(64, sizeof(hosac_t));
+
+  if (s) memset(s, 0, sizeof(hosac_t));
+  
+  return s;
+}
+
+// runs 'samples' (per lane, rounded up to 64) split across 'threads'
+// and returns the summed tables (caller frees) or null on failure
+hosac_t* hosac_run(mix_func_t f, uint64_t samples, uint32_t threads, uint32_t tests)
+{
+  hosac_job_t job[64];
+  uint64_t    blocks = (samples+63) >> 6;
+  uint64_t    base   = 0;
+
+  if (threads == 0)  threads = 1;
+  if (threads > 64)  threads = 64;
+  if (threads > blocks) threads = (uint32_t)blocks;
+
+  for(uint32_t i=0; i<threads; i++) {
+    uint64_t n = blocks/threads + (i < blocks % threads);
+    
+    job[i].s      = hosac_alloc();
+    job[i].f      = f;
+    job[i].base   = base;
+    job[i].blocks = n;
+    job[i].tests  = tests;
+    base         += 256*n;
+
+    if (job[i].s == 0) {
+      fprintf(stderr, "error: allocation failed\n");
+      while(i--) free(job[i].s);
+      return 0;
+    }
+  }
+
+  for(uint32_t i=1; i<threads; i++)
+    job[i].started = pthread_create(&job[i].thread, 0, hosac_worker, job+i) == 0;
+
+  hosac_worker(job);
+
+  // jobs without a thread are run here
+  for(uint32_t i=1; i<threads; i++)
+    if (!job[i].started) hosac_worker(job+i);
+
+  for(uint32_t i=1; i<threads; i++) {
+    if (job[i].started) pthread_join(job[i].thread, 0);
+
+    // fold into the first
+    u32x4_t* d = &job[0].s->sac[0][0];
+    u32x4_t* a = &job[i].s->sac[0][0];
+    size_t   n = (sizeof(hosac_t)-sizeof(uint64_t))/sizeof(u32x4_t);
+
+    for(size_t k=0; k<n; k++) d[k] += a[k];
+
+    job[0].s->n += job[i].s->n;
+    free(job[i].s);
+  }
+
+  return job[0].s;
+}
+
+// correlation of two bernoulli: joint count c11 and marginals c1,c2.
+// NAN if either marginal is degenerate (output bit never or always
+// flips) since the correlation is undefined
+static inline double hosac_corr(double n, double c1, double c2, double c11)
+{
+  double p1 = c1/n;
+  double p2 = c2/n;
+  double d  = sqrt(p1*(1.0-p1)*p2*(1.0-p2));
+
+  return (d != 0.0) ? (c11/n - p1*p2)/d : NAN;
+}
+
+void hosac_report(char* name, hosac_t* s, uint32_t tests)
+{
+  double n = (double)s->n;
+
+  // expected mean |r| or |bias| of an ideal function: E|N(0,1/n)|
+  printf("%s: %" PRIu64 " samples per lane. noise floor ~ %10.8f\n",
+	 name, s->n, sqrt(2.0/(M_PI*n)));
+
+  for(uint32_t l=0; l<4; l++) {
+    if (tests & HOSAC_SAC) {
+      seq_stats_t stats;
+      double      max = 0.0;
+      double      sc  = 2.0/n;
+      uint32_t    mi=0,mj=0;
+
+      seq_stats_init(&stats);
+
+      for(uint32_t i=0; i<64; i++) {
+	for(uint32_t j=0; j<64; j++) {
+	  double b = fabs(fma((double)s->sac[i][j][l], sc, -1.0));
+
+	  seq_stats_add(&stats, b);
+
+	  if (b > max) { max = b; mi=i; mj=j; }
+	}
+      }
+
+      printf("  lane %u SAC  : |bias| = %10.8f ±% 10.8f : max = %f (flip %2u, out %2u)\n",
+	     l, stats.m, seq_stats_stddev(&stats), max, mi,mj);
+    }
+    
+    if (tests & HOSAC_BIC) {
+      seq_stats_t stats;
+      double      max = 0.0;
+      uint32_t    mi=0,mj=0,mk=0;
+      uint32_t    nd=0;
+
+      seq_stats_init(&stats);
+
+      for(uint32_t i=0; i<64; i++) {
+	for(uint32_t j=0; j<64; j++) {
+	  double cj = (double)s->sac[i][j][l];
+	  for(uint32_t k=j+1; k<64; k++) {
+	    double ck = (double)s->sac[i][k][l];
+	    double r  = fabs(hosac_corr(n, cj, ck, (double)s->bic[i][j][k][l]));
+
+	    // constant output bit: not a dependence. counted separately
+	    if (isnan(r)) { nd++; continue; }
+	    
+	    seq_stats_add(&stats, r);
+
+	    if (r > max) { max = r; mi=i; mj=j; mk=k; }
+	  }
+	}
+      }
+      
+      printf("  lane %u BIC  : |r|    = %10.8f ±% 10.8f : max = %f (flip %2u, out %2u,%2u)\n",
+	     l, stats.m, seq_stats_stddev(&stats), max, mi,mj,mk);
+
+      if (nd != 0)
+	printf("  lane %u BIC  : %u pairs with a constant output bit (excluded)\n", l, nd);
+    }
+    
+    if (tests & HOSAC_SAC2) {
+      seq_stats_t stats;
+      double      max = 0.0;
+      double      sc  = 2.0/n;
+      uint32_t    mi=0,mj=0,mk=0;
+
+      seq_stats_init(&stats);
+
+      for(uint32_t i0=0; i0<64; i0++) {
+	for(uint32_t i1=i0+1; i1<64; i1++) {
+	  for(uint32_t j=0; j<64; j++) {
+	    double b = fabs(fma((double)s->sac2[i0][i1][j][l], sc, -1.0));
+	    
+	    seq_stats_add(&stats, b);
+
+	    if (b > max) { max = b; mi=i0; mj=i1; mk=j; }
+	  }
+	}
+      }
+
+      printf("  lane %u SAC2 : |bias| = %10.8f ±% 10.8f : max = %f (flip %2u,%2u, out %2u)\n",
+	     l, stats.m, seq_stats_stddev(&stats), max, mi,mj,mk);
+    }
+  }
+}
+
 
+//------------------------------------------------
+// the mixers that can be examined
+
+// a fixed generator for mixers that use per generator data (vprng_aes)
+static vprng_t hosac_prng;
+
+static u64x4_t hosac_vprng(u64x4_t x)  { return vprng_cast_u64(vprng_mix(&hosac_prng,x)); }
+static u64x4_t hosac_local(u64x4_t x)  { return vprng_cast_u64(local_mix(x));      }
+static u64x4_t hosac_nl(u64x4_t x)     { return vprng_cast_u64(local_nl_mix(x));   }
+static u64x4_t hosac_og(u64x4_t x)     { return vprng_cast_u64(og_mix(x));         }
+static u64x4_t hosac_mix64(u64x4_t x)  { return vprng_cast_u64(mix_64(x));         }
+static u64x4_t hosac_mix32(u64x4_t x)  { return vprng_cast_u64(mix_32(x));         }
+
+typedef struct { char* name; mix_func_t f; char* desc; } hosac_mix_t;
+
+hosac_mix_t hosac_mix[] = {
+  {.name="vprng",    .f=hosac_vprng, .desc="vprng_mix of the build (" VPRNG_NAME ")"},
+  {.name="local",    .f=hosac_local, .desc="local_mix: WIP 3 product"},
+  {.name="nl",       .f=hosac_nl,    .desc="local_nl_mix: 2 product"},
+  {.name="og",       .f=hosac_og,    .desc="original (v0.0.1) mixer: 2 product"},
+  {.name="mix64",    .f=hosac_mix64, .desc="64-bit product reference (mix03)"},
+  {.name="mix32",    .f=hosac_mix32, .desc="vpcg32 32-bit finalizers"},
+};
+
+void help_options(char* name)
+{
+  printf("Usage: %s [OPTIONS]\n", name);
+  printf("\n"
+	 "  no options: per lane SAC dumps of 'hack_hash' (v0.0.1_*.dat files)\n"
+	 "\n"
+	 "  --sac        strict avalanche criterion\n"
+	 "  --bic        bit independence criterion\n"
+	 "  --sac2       two bit flip SAC\n"
+	 "  --mix=NAME   mixer to examine (default: vprng)\n"
+	 "  --samples=N  samples per lane (default: 2^18)\n"
+	 "  --threads=N  (default: number of cores)\n"
+	 "  --help\n"
+	 "\n"
+	 "mixers:\n");
+  
+  for(uint32_t i=0; i<LENGTHOF(hosac_mix); i++)
+    printf("  %-8s : %s\n", hosac_mix[i].name, hosac_mix[i].desc);
+
+  exit(0);
+}
+
+uint64_t parse_u64(char* str)
+{
+  return strtoul(str, NULL, 0);
+}
+
+int main(int argc, char** argv)
+{
+  static struct option long_options[] = {
+    {"sac",        no_argument,       0, 's'},
+    {"bic",        no_argument,       0, 'b'},
+    {"sac2",       no_argument,       0, '2'},
+    {"mix",        required_argument, 0, 'm'},
+    {"samples",    required_argument, 0, 'n'},
+    {"threads",    required_argument, 0, 't'},
+    {"help",       no_argument,       0, '?'},
+    {0,            0,                 0,  0 }
+  };
+
+  uint32_t     tests   = 0;
+  uint64_t     samples = 1<<18;
+  uint32_t     threads = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  hosac_mix_t* mix     = hosac_mix;
+  
+  while (1) {
+    int option_index = 0;
+    int c = getopt_long(argc, argv, "", long_options, &option_index);
+
+    if (c == -1) break;
+
+    switch(c) {
+      case 's': tests  |= HOSAC_SAC;  break;
+      case 'b': tests  |= HOSAC_BIC;  break;
+      case '2': tests  |= HOSAC_SAC2; break;
+      case 'n': samples = parse_u64(optarg); break;
+      case 't': threads = (uint32_t)parse_u64(optarg); break;
+
+      case 'm': {
+	uint32_t i = 0;
+	while(i < LENGTHOF(hosac_mix) && strcmp(optarg, hosac_mix[i].name) != 0) i++;
+
+	if (i == LENGTHOF(hosac_mix)) {
+	  fprintf(stderr, "error: unknown mixer '%s'\n", optarg);
+	  return -1;
+	}
+	mix = hosac_mix+i;
+      }
+      break;
+	
+      default: help_options(argv[0]); break;
+    }
+  }
+  
+  if (tests == 0) {
+    dumb_vle_sac("v0.0.1_0",  hash0);
+    dumb_vle_sac("v0.0.1_1",  hash1);
+    dumb_vle_sac("v0.0.1_2",  hash2);
+    dumb_vle_sac("v0.0.1_3",  hash3);
+    return 0;
+  }
+
+  vprng_global_id_set(1);
+  vprng_init(&hosac_prng);
+  
+  hosac_t* s = hosac_run(mix->f, samples, threads, tests);
+
+  if (s) {
+    hosac_report(mix->name, s, tests);
+    free(s);
+    return 0;
+  }
+  
+  return -1;
+}
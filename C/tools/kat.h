@@ -0,0 +1,268 @@
+// known-answer vectors for self_check. generated by: self_check_{variant} --kat
+// (see self_check.c for the configuration)
+
+#define KAT_LEN 8
+
+typedef struct {
+  char*   name;
+  uint32_t words;       // VPRNG_STATE_WORDS (0 = 1)
+  u64x4_t v[KAT_LEN];   // first vprng  results
+  u64x4_t c[KAT_LEN];   // first cvprng results
+  u64x4_t vd;           // vprng  digest
+  u64x4_t cd;           // cvprng digest
+} kat_t;
+
+static const kat_t kat_table[] = {
+  {
+    .name = "vprng",
+    .v = {
+      {0x32a6a50b0eee12b3,0x5c970c5c74ec1c01,0x0b8cea2d84c7807e,0x6da653f07c4f30a5},
+      {0x7693c5c5199065fe,0xb7c31d5e80a5da7c,0xa2604ffea1ed9300,0x2b48bbc888965c82},
+      {0x114f97e607608c05,0x03e99f3c4489ee4b,0x9375b55fbea7c155,0x04bf2bf93e760e45},
+      {0x216c0fe8e55e9ca5,0xd73182d4ce94dd64,0x365fc395f1728f15,0x51a2035ab1d0b469},
+      {0xa489ec589ffe91c3,0x90da7d0afc31be32,0x789d79cad632a8b3,0xefc08f3ad8f15ffc},
+      {0xaab87cdad13e5b7a,0x3b9353219a09604f,0x6dd9b1b96a0bda43,0x3ef8c1d76ca3d670},
+      {0x10d0c8651d52e849,0xbb04808ab564ae72,0x07e844b7c32fc079,0x11df297c7f65295b},
+      {0x1b1cb6b75c99902d,0x24c801626f09fa19,0x1c6e2fc43b6a0bb3,0x314b5b98a08d0b5a},
+    },
+    .c = {
+      {0x2501debe1a6be3d7,0x2be8ac1392cc9f9b,0xd1ec83238581836d,0xf9e40415bb0a669a},
+      {0xe69707280809a977,0xef61d655307015fc,0xb414f5edef2ce557,0x301ea64c4e94f4c2},
+      {0x62a6dc08a459b4ad,0x5a5947d102f8a448,0x781ff2d60536c850,0x138e17b34f5f77dc},
+      {0x3dae917a86505267,0xc16efa9aeab36a1e,0x655b96c3b5727db5,0x5f8fb5a3e478d55d},
+      {0x451185d45d8d94ae,0x806495e0945ff664,0x18ba23bbf8ebbdc6,0x31eec23930fadb75},
+      {0xa0614876db289697,0xf6051b8df03a955e,0x611cd70341b95a4e,0xd0882d8331115bb9},
+      {0xd846321dc6ccfefd,0x1e96432b47cd68e8,0x9a40a1a9f011a3e0,0x8f27b8c524149ede},
+      {0x22a200e632d0005d,0xe9988182d186513e,0x51c6d62b76baeabb,0xd3f970e7b50c9e8f},
+    },
+    .vd = {0x2079ecf504ab203d,0xa1557f589d05289c,0x4833861f00878d00,0x187b1cb4cc1ade5f},
+    .cd = {0x2da4005ecd46cb1f,0x188e27b199b7a9ba,0x190a090f4cfa036c,0xb467a27aede0e782},
+  },
+  {
+    .name = "vpcg",
+    .v = {
+      {0x61f10c816fd175e0,0xceb552e6cacd48d3,0x77a923165df72708,0x7e96d58825cfb08e},
+      {0xe7fb38eca31b8396,0x5aa451ac998d5b74,0x3e1eb92c27c09603,0x89d259cdbfe0aca3},
+      {0xe43cd1ba967f2471,0xd5b81442d063dc9d,0xe5ee3182fd0d66f9,0x00e980f413185c7d},
+      {0x9f1aa1511a8673c3,0xcd7b9f678ae57567,0xb64514620d5367e2,0xc5de270726adc0f5},
+      {0x2477c723a18ea1bb,0xe5f24fbb647509e4,0x325987e94ae5ca93,0xbfe07244e28db115},
+      {0xf70b65129f36c3f1,0x1c4d1b244052b8aa,0x52be7cc42d096a34,0x58702516e4be57e1},
+      {0xe7e9a6122f2d9c3e,0xac9dc2fa3eced2d7,0x7bf6e92c4f57a91a,0x138bcce6f53a3ef8},
+      {0xda141c33964a4791,0x76f4a8349f1a0a43,0x649771242a8ece3d,0x9825a4b2a63c9155},
+    },
+    .c = {
+      {0xee826e9644523f8d,0xb163272515c08117,0x380ab80ab594c30c,0xf852b572b9abedd4},
+      {0xd760881f1f4524b5,0x326992eb9f736232,0xf9bbfbe8c13894bb,0x38f9c1d70ff2fd98},
+      {0x28a04e873eb3e7cd,0x28119c7e23c0ba4d,0x683062aa43fbef1c,0xe383d486bb09fc31},
+      {0xbf1c08f9906ade42,0xab6faeb36fd1c149,0x321ef1e213424817,0xcdb078f885c346c5},
+      {0x24d0edd501655be6,0x4f54a0dd85bc1516,0xb5cfb2a0bd6e8ad5,0x660d1aa53a38e386},
+      {0x1c635da9693e376b,0xa5f60e492da8d1e2,0xf25ddeb0123823fb,0xe8c21efaeaafcde7},
+      {0xf8ac503f5087173f,0x2168d8c2a28cfc73,0x82162c591e67225e,0x4e8129ff63b05976},
+      {0x8279dc998d9ff028,0xaf753e382882cd2c,0x4c8daf813bee3aba,0x59f22bec92f56180},
+    },
+    .vd = {0x16ada1f966a49567,0x4d1a69a441a610ff,0xac9209c7ce5e321f,0x26d7ce071155862f},
+    .cd = {0xf8a9c615eb1b334d,0x1cbbafb502a37699,0x3ad15a8586a33364,0xe33a115ea7a9b6fa},
+  },
+  {
+    .name = "vpcg32",
+    .v = {
+      {0x58f68b505c573cf3,0x4a56efd094387ffc,0x5c79b890fa760ae5,0x315e7f9ff12d6618},
+      {0x0d70ed36237233af,0x3e3c1929f556a84d,0xad1651237829482f,0xdac91eb8b463db47},
+      {0x92e1ca7f6cef6d68,0x4bdd4818fdcf6627,0x8f700eb7391b07e5,0x2ce81603d796567b},
+      {0x7fa90e6e9151699f,0xe414f419a663ed0b,0x13b643a7f36516e2,0xdb5f4af4d94ef377},
+      {0xef9938a099d33832,0xbadc7fad1011558b,0x33e80fab7414868d,0xa5395b6d36a6277c},
+      {0x292fbcf220dad9c8,0xde7392741e99c61f,0x3c7a090587aa91ba,0x1ab28efe887dc4c5},
+      {0x60d3f0b49b264c27,0x13afbb7e4278125e,0x5b98eeaa8cbc4ac8,0x1fa89519bbe08cdd},
+      {0xb977a8785231f828,0x3ed51bc4627afb4e,0x98d87fe85bda1e0c,0xf22fa41a5dadba98},
+    },
+    .c = {
+      {0xab6cc4e082d9976f,0x53224ecff383f506,0xb9d33d974659fbdd,0xef59a16894aa4ccd},
+      {0xadf95a018afbc573,0x6c31ddb5ca236f43,0xee1625b33ec1a5ae,0x3d98641411f285a9},
+      {0x439c74c4610984f2,0xeee1efaa49f7fc2f,0xfb7db8c0938f4f7b,0x56e37ce92b265b10},
+      {0xa190df57a4109c5d,0xca04d666823b24ff,0x88ad387ce1dd483f,0x70d3e9aaaabf9fc1},
+      {0x333042373a6e37f4,0x01cf2c1919888d33,0x6ce6de94b640b8c6,0x4e0ef082b9a99348},
+      {0x5e18b522d99c0bab,0xeb8313e0e6fc6439,0xf761f062c4eb5a80,0x7b73cb45bbac62ad},
+      {0xa87b49c28bdcb841,0x0effb45d16144426,0xdeaab0a1f301a310,0xd4b05143a1ec6e2c},
+      {0xfdab89e2ca05538f,0xd0753ebc7f48c1d8,0x3fa7950355855621,0x3a7eb2a9adf0f77e},
+    },
+    .vd = {0x3b763c89bb107bc2,0xb84b15438055b422,0xbf1d567cde58e23e,0xe272b9a0dc829c78},
+    .cd = {0x5099a47fba31f208,0x3fe3393d53263d7a,0xd04c5df6f0ab119e,0x4536804c9e763eb5},
+  },
+  {
+    .name = "vsplitmix",
+    .v = {
+      {0x61f10c816fd175e0,0xceb552e6cacd48d3,0x77a923165df72708,0x7e96d58825cfb08e},
+      {0x04e08ecd7dd4fee6,0x076621460c7a4046,0x4b5b112028e42c45,0x0a3ca32b5a062aaf},
+      {0x7f1768e3fc4aeca4,0x3b457f5321b79b3a,0x0a7946f1825a62c8,0x91e114b0669c7fec},
+      {0xd4da0688e93159ca,0xc7d03002fd9a1271,0x8ef6d5b72ee4cd79,0x960da18e9a6243c7},
+      {0xa5225f1050b1aade,0x58ed11280cab1a20,0xd06984d25690b82a,0xcbd6d682bd47813b},
+      {0x3daa17768321f77f,0x522546f635d00d0c,0xd4fc8f762551aef6,0x31b878b6f807bd76},
+      {0x3b15b17555cf421e,0x77a51fbea2a29e10,0xf88f01bf9f464c59,0xebf1024b341e909a},
+      {0xe574a64d11350f5a,0x8be0d5ebd8b6ad9b,0x2bd630b75af533b8,0x26a0065094b9414e},
+    },
+    .c = {
+      {0xee826e9644523f8d,0xb163272515c08117,0x380ab80ab594c30c,0xf852b572b9abedd4},
+      {0x0b402ffce98e53e6,0xe8bcad9ab573847e,0xd868eda5aab5ee85,0xf1f433a7e841df9e},
+      {0x1bb1b5dd511184fc,0x2ca4d622a728f1b8,0x7fca2a9e3351cc6b,0x8111a19121226151},
+      {0xf3733c879edbff6e,0xb1a0b2fc0b026d1a,0x714c065b5fd3a869,0x232342311a1f62fd},
+      {0x4b26c69e538fa0cb,0x79395f81a30820d7,0x1b49ba0bea550ab4,0x79333a8862ed10b8},
+      {0x402f9b7f91c8a477,0x5157570c3878d420,0x4e2785cdb00a8bcb,0x2b37209bf6cc89e2},
+      {0x367249a89d87456b,0x76bd9f8db04d6ad7,0x3e0f6c82cff6cff2,0x01a886ca5bb021a4},
+      {0x2f0666d5589cd113,0xf1e81af57fcee59b,0x8fc2feb32bc79a28,0x87ff76e3c15e3db3},
+    },
+    .vd = {0x2219290808facb79,0x1a806f91e7a092c6,0xf14c76eea6faab41,0xf7b569f48475a985},
+    .cd = {0xc158b13dec63722d,0xbfaae691577655da,0xb65296d1a32b2d97,0xf5d3e8bdad4ad447},
+  },
+  {
+    .name = "vprng_aes",
+    .v = {
+      {0x209ce3108e163b9c,0x749e79e28d3f26af,0x365e0317652a5d19,0xedebf1ac9a201fc6},
+      {0x5be9d296d81891ad,0x4e00e5c34e7278dc,0x0805311bdc580315,0x55207fcc5cb63699},
+      {0x1cbe62e076dff400,0xdf34d0e51505ec32,0x88194370cb597877,0xd49c77ba8cc49c12},
+      {0x7c1cee23c5f275fe,0x8d36e613e3d7201e,0x3089334391176a71,0x24b37333234c89c3},
+      {0xa72095e38ae4aa38,0x67e97e944755402e,0x5964a1aff6a6df16,0xf3174ce5b0b86d9b},
+      {0xedd7534e0f0d3775,0x9e51aba9d877952b,0xaedaa2b105371e31,0x5fa8e5e875adf518},
+      {0x16fa5e77cf2d664f,0x6d4d4d4c3df2e071,0x0830ef21e3775f9c,0x6adf867ed1bf535a},
+      {0x097cd9297f94cad8,0x7b69e521040f341a,0x194455340087a7d0,0x93cfd7c04c117e94},
+    },
+    .c = {
+      {0x4b932b66b02e6910,0x6b670afee37e0824,0xb0dce928f4db2ab3,0x9329efd5ffb7cb6e},
+      {0x8395eef72a16a85d,0x185b651e7ae176fd,0x45ae5c32738fa1a5,0xa04b9828a6e62816},
+      {0x04b34ebda46c4d77,0xd3c42860ddbea8b6,0x95ab27694651bd40,0x58cd43ff8e1f73bf},
+      {0x34452a3d4e9abd42,0xbf863ca1e751a075,0xbea854f8b680ee93,0x724c8f5877fa3bbc},
+      {0x9e2d62da903142f7,0xa5afb589257ce87d,0x11b72d10a86dda93,0x62513c8d43437c4a},
+      {0x8047d2b06c943e95,0xc21fecd1bdf0a1e1,0x2c7ebdd991c5c4d1,0x8da18f826d704e3a},
+      {0xf5673efb7b56b2b9,0xdc806233496b833e,0x07997de0cc783e75,0x13c762e29f285222},
+      {0xb319ccc3be0fb60c,0x68cb2af8af7f4031,0x72314cbdf181f2b9,0x6fd0b8ece230956d},
+    },
+    .vd = {0x2aff19a36ec9c499,0x9b1a55703f3ec2ac,0xd9af0b74f626c504,0xc6ab88f38f08bec9},
+    .cd = {0x6f4de3cec2b707ec,0xd464f8965ae2d268,0xabd870cb4021f5fb,0x535b25a4d02d1299},
+  },
+  {
+    .name = "vprng_aes_r1",
+    .v = {
+      {0x607266f4ee4ce2ce,0x077f968101ca032e,0xfa03b8ae15cc19e6,0x6b957e5e3f4737ad},
+      {0xf535350eeada6bbb,0x09a7d3dafb202642,0x9db5f5d3dcafe3e1,0x49a4320189917d94},
+      {0xf3108f0406146ef1,0x0f2299456d5f84c6,0x6d03d25b61582fd4,0x43d023dfaa5d3fb5},
+      {0x6aeb51db989e24f7,0x259ad4111081e8ee,0x9e0ea6eea4e4b68d,0x339b0f5d89e38048},
+      {0x6498ea64856074ea,0xafa57b7bd44b4818,0xcec42ddae8f02619,0x2a6742c5e5989e79},
+      {0xc8b1db02a13dfe55,0x6def430030fb2789,0x8cd5db383767e96a,0x29c9828a72d9b91d},
+      {0xcb2f31077ca10b31,0x9cc54d4ff632317e,0x3c7b01fc1d9245e5,0x504ca2b18285c037},
+      {0xad8c97401878723d,0xeba11ea4abf2abde,0x42727cf4b0ffdeb1,0x2cb1d69e8806c934},
+    },
+    .c = {
+      {0xa8bda70922673b30,0xb3c0807a00ae275e,0xb715e80ee9650e60,0xfbd8ddb83188bf0e},
+      {0xc6cb98ca6359dd1f,0xd00236e13140dc40,0x9ecfb46d985f1d55,0xf2ecaeb47b24728b},
+      {0x387e126b86380627,0x3bdc2f497b32979e,0x8090ee5edebadcdf,0x7b36877f88ccf87c},
+      {0x04d2ffc7b338b66a,0xe6f39982adea5644,0x17be526f3b687d3a,0x7ec8d9f11fd7e4eb},
+      {0x09968e98609f97ea,0x9c2d7fbf7dab2889,0xccc096c04fde1b19,0x9392670e2a94e8dc},
+      {0x05a64b9509aa93f1,0xbd7e174d94f38115,0x76e4378fbd748bfd,0xd031fd7a0f12f2ba},
+      {0x7ff24047aff0a84b,0x56534704b344396a,0x5b8113d01eb214e3,0xdad05550ee0452b9},
+      {0x78471fb2a59ca078,0x4d338571cc1a23b2,0xa2f9f0f639d32520,0x88ec4fc0c3048dac},
+    },
+    .vd = {0x43576b65c1ae3127,0xdcb887d82bea7d3e,0x70e0c28507b2f0ac,0xd17b4757edc8fe8d},
+    .cd = {0xdceea8d96ce10e79,0x8ea2ddb18463eb7f,0x24f70525169b6ab3,0x321aa11a8c022ff1},
+  },
+  {
+    .name = "vprng_aes_r3",
+    .v = {
+      {0x6a5958d2213354c5,0x7f6efd1133006402,0x59776549029e106a,0x9deac789b548c8aa},
+      {0x571054ab0c6aae2c,0xf9b6a471abd6ee32,0xae17823682a647e4,0x136cd4becd3bcb31},
+      {0x7f0e15fd401daa60,0x999e92009448f215,0x2c50f35791b4083d,0xed030a18d165ae43},
+      {0x6e33996049d301f0,0xeea46c4f8d46f135,0x1ca61a677bd3d6aa,0xfdaa8d9e39d530e3},
+      {0x39ff3c14cde16cbf,0x6c549d384d773f98,0x22212b498e013f0f,0x32a7423080b0f57d},
+      {0x877f06cab127f645,0x72a211e32b5a161c,0x50554a5e7b3d7d37,0xf8af85f540ef418e},
+      {0xe815fbed3d2a2df8,0x617d818977a15e3d,0xac5df70fa9acc461,0xf322da0934d816af},
+      {0x4b60341fa160157c,0xcdf0491b38bf78cd,0x7618609a4e577717,0x8aff983df0e6c754},
+    },
+    .c = {
+      {0xd4794319bafce7bd,0x9b86a2344d7e0c86,0x62f9221ea0fec83b,0x009fcb26359819c0},
+      {0x894fd50946d80703,0x9bc5d7cd093bff15,0x06b9696b16cb5e0a,0x88eddd7a1cd62498},
+      {0x2302ebb14a8c81fe,0x36e5e5ad755430a3,0x77a019c9c05b1e41,0x5ad7c35dbb566a04},
+      {0x72677c5353d33803,0x3b677e94e3b68f66,0x757ac895f1dd0e18,0xef8d0c1f6afd75fd},
+      {0x3ac7f24c0d53b495,0x32352d422221038c,0xfa6723e1f16e56d6,0x67399774955bc9ee},
+      {0x81e7eb5e0e48548f,0xee0d5eef42bdc08c,0xbabfdfe5d0bac148,0xe8e2874990b4f298},
+      {0x9358c29023308b2e,0xd0fc9cfe3dd3c70c,0x89f298198e36fcc4,0x08cf8b57158dd260},
+      {0xc2a9d0bb097ee51b,0xe1635d7927faf57b,0x6c117c169f2f05cd,0x663593dc980ba441},
+    },
+    .vd = {0xea0dc68e856ecc22,0x7183bc6319079adc,0x74cd7116a020ddf0,0x1ea96a0c54e3caff},
+    .cd = {0x4bc05d4eb187fb03,0x27b1c540e10d09df,0xcd0ed3f6274b768c,0xfff33bfff36a653d},
+  },
+  {
+    .name = "vprng_aes_r4",
+    .v = {
+      {0xe4ed13caccb7ebf9,0xfcb4d9424a158112,0xd17d72b92ed9de7e,0x6b3d6705ef97ef13},
+      {0x3aed7910e7c6474c,0x03abc9f7d82eee05,0x7badbf743bf2e1d9,0xcfecddc4ad5ddd4c},
+      {0x71f22e362cd4944d,0xf1217a95ff85e0d4,0x76f3e367089f51e0,0xe4bc984966422ba0},
+      {0xe88c0e2de07e63f9,0x8547e13cf21d01ff,0x6383248c6d244c48,0xfc461c146b929ffe},
+      {0x3c31aaf12d327f32,0x8580e03e0868f945,0xd86c761e41e77081,0x1219a1923728b2bf},
+      {0x77261bcf6876c732,0x4d2197f29f09d9a4,0x4d68886ab5faf871,0x37248b0d7d981425},
+      {0x0ba3bf86b0d008ef,0x950c8cbfede192e5,0xee40e279b2827fb0,0x74686b473412ecca},
+      {0x120b79e6ca146b1c,0x7a81ef4c0a5e118e,0x40015d1f227552c1,0x25d9285e4d357b28},
+    },
+    .c = {
+      {0x33876c06c471ba9c,0xc00097f79670b1ff,0x5f1230a4a58898f5,0x535284ec7e80fa9e},
+      {0x1a8ce1d8cf4bbaa4,0x88ad248591ca43a7,0x7108ccaabeeea54d,0x4f5492b88aa59365},
+      {0x342601949ecdf9c9,0xe90e17faafdc2be7,0x0234160f1727a8d4,0x9e05e731ab071280},
+      {0x06811520871a85cb,0xd1c237ec0061268f,0xfad72a087e47ab48,0x39076490a222742c},
+      {0x3e25ce82c7f7f2ab,0x155d71b4c24b6117,0x98dba93884e69a80,0xda89cb6d755fb6a0},
+      {0xd5939905ddc6f235,0x817d8a48fe212cbf,0x9cc974dd43ab8caa,0xea362da39a089974},
+      {0x87957d1b7b984fba,0xd8fec65220fa8b87,0x77675ef8d460a93e,0x71cc679846b8009f},
+      {0x27c04d18d7462ea1,0x5f58232dd6529081,0xa66dc8040a7e3de8,0xe3fd155bb7284de6},
+    },
+    .vd = {0xf694233fb22e1d3a,0xde77edab19427717,0x97329c7991d45afc,0xddd755c457987fe8},
+    .cd = {0xbc7bc5999a740b4e,0x68efd5139cf3e404,0x554348263f48ea03,0x184a50a2c0bb3e82},
+  },
+  {
+    .name = "vprng",
+    .words = 2,
+    .v = {
+      {0x32a6a50b0eee12b3,0x5c970c5c74ec1c01,0x0b8cea2d84c7807e,0x6da653f07c4f30a5},
+      {0x7693c5c5199065fe,0xb7c31d5e80a5da7c,0xa2604ffea1ed9300,0x2b48bbc888965c82},
+      {0x114f97e607608c05,0x03e99f3c4489ee4b,0x9375b55fbea7c155,0x04bf2bf93e760e45},
+      {0x216c0fe8e55e9ca5,0xd73182d4ce94dd64,0x365fc395f1728f15,0x51a2035ab1d0b469},
+      {0xa489ec589ffe91c3,0x90da7d0afc31be32,0x789d79cad632a8b3,0xefc08f3ad8f15ffc},
+      {0xaab87cdad13e5b7a,0x3b9353219a09604f,0x6dd9b1b96a0bda43,0x3ef8c1d76ca3d670},
+      {0x10d0c8651d52e849,0xbb04808ab564ae72,0x07e844b7c32fc079,0x11df297c7f65295b},
+      {0x1b1cb6b75c99902d,0x24c801626f09fa19,0x1c6e2fc43b6a0bb3,0x314b5b98a08d0b5a},
+    },
+    .c = {
+      {0x84a7ed64a870d7fb,0xc2a0ea80b70bbf0d,0x1db818d8d76f9f2e,0xa66bfe131fa682d6},
+      {0x42bcd4533f9f63a7,0x3bb2dab2a95b5d99,0xb111a86943a5d986,0xfbea495680d3d643},
+      {0x617eaf26cbf2317e,0x02e595be82d75933,0xb08fa345287022b0,0xecf1b547ddc4bd88},
+      {0x35648ddeb07c8bef,0xd37d40d1ea41fbb2,0x7f027e612e766693,0x7f358f78e665681b},
+      {0x2c5ebaf9da0d310a,0x7a115b46fd261428,0x526a1f519317cc62,0x7a40d42ce09b49d9},
+      {0x0c9fa8d2966e3ae2,0xb7f2b1c3b70c6e66,0x49d46b62584c21a2,0x44a5ee4b156fcf32},
+      {0xa96c3b9790b7789b,0xf7d7a9ac564cb0d8,0x974d6017ee0ac554,0xb6aea8475b8ab915},
+      {0xd609c74b6c708033,0x4705b9c7ea6fa29f,0x92fc579074f1a844,0x8b4559cf95ec59c5},
+    },
+    .vd = {0x2079ecf504ab203d,0xa1557f589d05289c,0x4833861f00878d00,0x187b1cb4cc1ade5f},
+    .cd = {0xee38f63f70e9a598,0xd520d542f4720184,0x9059af607e7b5cca,0xe2719fefd04c129d},
+  },
+  {
+    .name = "vprng",
+    .words = 4,
+    .v = {
+      {0x32a6a50b0eee12b3,0x5c970c5c74ec1c01,0x0b8cea2d84c7807e,0x6da653f07c4f30a5},
+      {0x7693c5c5199065fe,0xb7c31d5e80a5da7c,0xa2604ffea1ed9300,0x2b48bbc888965c82},
+      {0x114f97e607608c05,0x03e99f3c4489ee4b,0x9375b55fbea7c155,0x04bf2bf93e760e45},
+      {0x216c0fe8e55e9ca5,0xd73182d4ce94dd64,0x365fc395f1728f15,0x51a2035ab1d0b469},
+      {0xa489ec589ffe91c3,0x90da7d0afc31be32,0x789d79cad632a8b3,0xefc08f3ad8f15ffc},
+      {0xaab87cdad13e5b7a,0x3b9353219a09604f,0x6dd9b1b96a0bda43,0x3ef8c1d76ca3d670},
+      {0x10d0c8651d52e849,0xbb04808ab564ae72,0x07e844b7c32fc079,0x11df297c7f65295b},
+      {0x1b1cb6b75c99902d,0x24c801626f09fa19,0x1c6e2fc43b6a0bb3,0x314b5b98a08d0b5a},
+    },
+    .c = {
+      {0xf08438abdd408efe,0x3681853546326cbd,0x56b997da5a32c95c,0xf08fd700e9663153},
+      {0x4f8b99bb5eeafb5a,0x6846e2166bdac93c,0x34027a6a5e706116,0x3d35e38ebea44a06},
+      {0x07fd6ad3931d5893,0x952f6dfc86a3d8d4,0xb7e86e88f9caea6e,0x22021a64136afba8},
+      {0xb55e338d2e22cb07,0x009382a84c9e2681,0xfc7c1221c5048fb3,0xd48c75ef0e7fdeb1},
+      {0x7d51a99a3aad9f2c,0x6b025f65296efd5e,0xb34ae5e0003caa0f,0xb7ba34b82c658ffa},
+      {0xfd9dae069eae603f,0x6bffae974eea2f65,0x2c3fb8d31db0d759,0x0844068554c2cab0},
+      {0x5611b2c58096cabc,0x317a86a5adb2fbb6,0xb154bf1f8eae7da1,0xec8abd1c601c42d8},
+      {0x56003c5e21b5fdf8,0x3e0b2c91f042bdae,0xd9446296f830e2a2,0x8e4fc105a8d40093},
+    },
+    .vd = {0x2079ecf504ab203d,0xa1557f589d05289c,0x4833861f00878d00,0x187b1cb4cc1ade5f},
+    .cd = {0x187fa9fa0599dc80,0x03f64a2609066b85,0xd4a38fabdc9a56d1,0xbb0cb5d84cbd10cd},
+  },
+};
@@ -10,7 +10,11 @@
 #include <fcntl.h>
 #include <time.h>
 #include <getopt.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
 
+#define VPRNG_IMPLEMENTATION
 #include "vprng.h"
 #include "common.h"
 
@@ -22,12 +26,6 @@ uint64_t get_timestamp(void)
   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
 }
 
-void printb(uint64_t v, uint32_t b)
-{
-  uint64_t m = UINT64_C(1)<<(b-1);
-  do { printf("%c", (v & m)!=0 ? '1':'.'); m >>= 1; } while (m != 0);
-}
-
 const uint32_t lcg_mul_k_table_32[] =
 {
   0x915f77f5, // 1..1...1.1.11111.111.1111111.1.1 : 21  9
@@ -48,7 +46,7 @@ const uint32_t lcg_mul_k_table_32[] =
   0x2c9277b5  // ..1.11..1..1..1..111.1111.11.1.1 : 17 10
 };
 
-void examine_current(u32x8_t f)
+void examine_table(void)
 {
   for(uint32_t i=0; i<sizeof(lcg_mul_k_table_32)/4; i++) {
     uint32_t v = lcg_mul_k_table_32[i];
@@ -59,6 +57,17 @@ void examine_current(u32x8_t f)
   }
 }
 
+void examine_current(u32x8_t f)
+{
+  for(uint32_t i=0; i<8; i++) {
+    uint32_t v = f[i];
+
+    printf("%08x ", v);
+    printb(v,32);
+    printf(" : %2u %2i\n", pop_32(v), bit_run_count_32(v));
+  }
+}
+
 
 typedef struct
 {
@@ -469,6 +478,580 @@ void test_table(void)
 }
 
 
+//*******************************************************************
+// vprng_mix lane finalizer search
+//
+// Each 64-bit lane of 'vprng_mix' is its own finalizer:
+//
+//   x ^= x >> s0;
+//   x ^= x >> s1; x = mul(x,m0);
+//   x ^= x << s2; x = mul(x,m1);
+//   x ^= x >> s3; x = mul(x,m0);
+//   x ^= x >> s4;
+//
+// where 'mul' is the pair of 32-bit products (each half of the lane
+// has its own constant). The shifts are shared by all lanes (vector
+// shift by constant) so four candidates can only be combined into
+// a 'vprng_mix' if their shifts match. The multipliers are per lane.
+// The op count is fixed: the search only walks the constants.
+//
+// Proposals are single/double bit flips of the multipliers (never
+// bit zero) and optionally +/-1 moves of a shift. Acceptance is
+// simulated annealing per worker thread. All workers feed a shared
+// best-N table which is periodically written to disk (along with
+// the walker states) so a killed run can be resumed.
+
+typedef struct {
+  uint32_t s[5];   // shift amounts (see above)
+  uint32_t m[4];   // m0.lo, m0.hi, m1.lo, m1.hi
+} mix64_def_t;
+
+// the defaults shifts of vprng_mix
+static const uint32_t mix64_shifts[5] = {33,16,16,16,32};
+
+// splatted copy of a definition: evaluates 4 inputs at once
+typedef struct {
+  u32x8_t  m0, m1;
+  uint32_t s[5];
+} mix64_k_t;
+
+static inline void mix64_k_init(mix64_k_t* k, const mix64_def_t* def)
+{
+  for(uint32_t i=0; i<8; i+=2) {
+    k->m0[i] = def->m[0]; k->m0[i+1] = def->m[1];
+    k->m1[i] = def->m[2]; k->m1[i+1] = def->m[3];
+  }
+  memcpy(k->s, def->s, sizeof(k->s));
+}
+
+static inline u64x4_t mix64(u64x4_t x, const mix64_k_t* k)
+{
+  x ^= x >> k->s[0];
+  x ^= x >> k->s[1]; x = vprng_mix_mul(x,k->m0);
+  x ^= x << k->s[2]; x = vprng_mix_mul(x,k->m1);
+  x ^= x >> k->s[3]; x = vprng_mix_mul(x,k->m0);
+  x ^= x >> k->s[4];
+
+  return x;
+}
+
+// lane 'l' of the current vprng_mix
+void mix64_def_current(mix64_def_t* def, uint32_t l)
+{
+  memcpy(def->s, mix64_shifts, sizeof(def->s));
+
+  def->m[0] = vprng_finalize_m0[2*l  ];
+  def->m[1] = vprng_finalize_m0[2*l+1];
+  def->m[2] = vprng_finalize_m1[2*l  ];
+  def->m[3] = vprng_finalize_m1[2*l+1];
+}
+
+void mix64_def_print(FILE* file, const mix64_def_t* def)
+{
+  fprintf(file, "%2u %2u %2u %2u %2u 0x%08x 0x%08x 0x%08x 0x%08x",
+	  def->s[0],def->s[1],def->s[2],def->s[3],def->s[4],
+	  def->m[0],def->m[1],def->m[2],def->m[3]);
+}
+
+// returns number of fields read
+int mix64_def_parse(const char* str, mix64_def_t* def)
+{
+  return sscanf(str, "%u %u %u %u %u %x %x %x %x",
+		&def->s[0],&def->s[1],&def->s[2],&def->s[3],&def->s[4],
+		&def->m[0],&def->m[1],&def->m[2],&def->m[3]);
+}
+
+bool mix64_def_valid(const mix64_def_t* def)
+{
+  for(uint32_t i=0; i<5; i++) if (def->s[i]-1 > 62) return false;
+  for(uint32_t i=0; i<4; i++) if ((def->m[i] & 1) == 0) return false;
+  return true;
+}
+
+
+// 64-bit version of 'stats32_t' (only the per bit counts are carried
+// since the row/column sums are cheap to rebuild)
+typedef struct {
+  uint32_t oi[64][64];  // [input bit flipped][output bit] counts
+  uint64_t n;           // number of inputs processed
+} stats64_t;
+
+// number of input vectors per transposed batch. fixed by the transpose.
+#define SAC_BATCH 64
+
+// gather SAC counts for 4*SAC_BATCH inputs: x_i = inc*(base+i)
+//   for each input bit flip: the 64 (x4 lanes) output deltas are
+//   transposed so each row is one output bit across all samples and
+//   the counts are then a popcount per row.
+static void sac_batch_64(stats64_t* s, const mix64_k_t* k, uint64_t base, uint64_t inc)
+{
+  u64x4_t x[SAC_BATCH];
+  u64x4_t h[SAC_BATCH];
+  u64x4_t t[SAC_BATCH];
+
+  for(uint32_t b=0; b<SAC_BATCH; b++) {
+    uint64_t i = base + 4*b;
+    x[b] = (u64x4_t){i,i+1,i+2,i+3} * inc;
+    h[b] = mix64(x[b], k);
+  }
+
+  for(uint32_t i=0; i<64; i++) {
+    uint64_t f = UINT64_C(1) << i;
+
+    for(uint32_t b=0; b<SAC_BATCH; b++)
+      t[b] = h[b] ^ mix64(x[b] ^ f, k);
+
+    bit_transpose_64x4(t);
+
+    for(uint32_t j=0; j<64; j++) {
+      u64x4_t c = vprng_pop_u64x4(t[j]);
+      s->oi[i][j] += (uint32_t)(c[0]+c[1]+c[2]+c[3]);
+    }
+  }
+
+  s->n += 4*SAC_BATCH;
+}
+
+// 64-bit version of 'sac_gof_32'
+void sac_gof_64(stats64_t* s, gof_t* gof)
+{
+  uint32_t oiI[64] = {0};
+  uint32_t oiO[64] = {0};
+
+  for(uint32_t i=0; i<64; i++) {
+    for(uint32_t j=0; j<64; j++) {
+      oiI[i] += s->oi[i][j];
+      oiO[j] += s->oi[i][j];
+    }
+  }
+  
+  double n  = (double)s->n;
+  double ei = 0.5*n;              // expected per bin
+  double er = 32.0*n;             // expected per row/column sum
+  double ie = 2.0/n;
+  
+  gof->perBitX2 = (100.0/(64.0*ei))*sqrt(gof_chi_squared_eq(&s->oi[0][0], 64*64, ei));
+  gof->iBitX2   = (100.0/er)*sqrt(gof_chi_squared_eq(oiI, 64, er));
+  gof->oBitX2   = (100.0/er)*sqrt(gof_chi_squared_eq(oiO, 64, er));
+  gof->maxBias  = 100.0*bias_max(&s->oi[0][0], ie, 64*64);
+  gof->iMaxBias = 100.0*bias_max(oiI, ie*(1.0/64.0), 64);
+  gof->oMaxBias = 100.0*bias_max(oiO, ie*(1.0/64.0), 64);
+}
+
+// search parameters
+uint32_t search_samples = 1<<18;        // inputs per candidate score
+uint32_t search_threads = 0;            // 0 = number of cores
+uint64_t search_iters   = 0;            // per walker. 0 = until killed
+uint32_t search_best    = 64;           // size of best-N table
+uint32_t search_save    = 30;           // seconds between table saves
+bool     search_shifts  = false;        // allow shift moves
+double   search_t0      = 0.05;         // initial annealing temperature
+double   search_cool    = 0.9995;       // per iteration cooling factor
+
+static const uint64_t search_inc = UINT64_C(0x9e3779b97f4a7c15);
+
+// the number used for ranking (smaller is better): chi-squared
+// of the full table plus worst single entry. Both are in percent
+// and the noise floors are ~100/sqrt(n) and ~400/sqrt(n) resp.
+static inline double mix64_rank(gof_t* gof)
+{
+  return gof->perBitX2 + gof->maxBias;
+}
+
+double mix64_score(const mix64_def_t* def, gof_t* gof, double* mean)
+{
+  static_assert(sizeof(stats64_t) < 32*1024, "keep it off the heap");
+
+  stats64_t s;
+  mix64_k_t k;
+
+  memset(&s, 0, sizeof(s));
+  mix64_k_init(&k, def);
+
+  for(uint64_t i=0; i<search_samples; i += 4*SAC_BATCH)
+    sac_batch_64(&s, &k, i, search_inc);
+
+  sac_gof_64(&s, gof);
+
+  if (mean) {
+    seq_stats_t stats;
+    seq_stats_init(&stats);
+    bias_foo(&stats, &s.oi[0][0], 2.0/(double)s.n, 64*64);
+    *mean = seq_stats_mean(&stats);
+  }
+
+  return mix64_rank(gof);
+}
+
+
+//-------------------------------------------------------------------
+// best-N table (shared by all walkers)
+
+typedef struct {
+  mix64_def_t def;
+  double      score;
+} mix64_entry_t;
+
+#define SEARCH_BEST_MAX 1024
+
+typedef struct {
+  pthread_mutex_t lock;
+  mix64_entry_t   e[SEARCH_BEST_MAX];   // sorted by score
+  uint32_t        n;
+  bool            dirty;
+} best_table_t;
+
+best_table_t best_table = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// caller holds the lock
+void best_table_insert_i(best_table_t* t, const mix64_def_t* def, double score)
+{
+  uint32_t n = t->n;
+
+  if ((n == search_best) && (score >= t->e[n-1].score)) return;
+
+  for(uint32_t i=0; i<n; i++)
+    if (memcmp(&t->e[i].def, def, sizeof(mix64_def_t)) == 0) return;
+
+  if (n < search_best) n++;
+
+  uint32_t i = n-1;
+
+  while(i != 0 && t->e[i-1].score > score) { t->e[i] = t->e[i-1]; i--; }
+
+  t->e[i].def   = *def;
+  t->e[i].score = score;
+  t->n          = n;
+  t->dirty      = true;
+}
+
+void best_table_insert(best_table_t* t, const mix64_def_t* def, double score)
+{
+  pthread_mutex_lock(&t->lock);
+  best_table_insert_i(t,def,score);
+  pthread_mutex_unlock(&t->lock);
+}
+
+
+//-------------------------------------------------------------------
+// annealing walkers
+
+typedef struct {
+  vprng_t  prng;
+  u32x8_t  buf;
+  uint32_t i;
+} walker_rng_t;
+
+static inline uint32_t walker_rng_u32(walker_rng_t* r)
+{
+  if (r->i == 8) { r->buf = vprng_u32x8(&r->prng); r->i = 0; }
+  return r->buf[r->i++];
+}
+
+static inline double walker_rng_f64(walker_rng_t* r)
+{
+  return (double)(walker_rng_u32(r) >> 8) * 0x1.0p-24;
+}
+
+typedef struct {
+  pthread_t    thread;
+  walker_rng_t rng;
+  mix64_def_t  cur;
+  double       score;      // of 'cur'
+  uint64_t     iter;       // completed iterations (persisted)
+  bool         resumed;
+} walker_t;
+
+#define SEARCH_WALKER_MAX 256
+
+walker_t        walkers[SEARCH_WALKER_MAX];
+pthread_mutex_t walker_lock = PTHREAD_MUTEX_INITIALIZER;
+uint32_t        walker_count = 0;
+atomic_bool     search_stop  = false;
+
+void mix64_propose(mix64_def_t* d, walker_rng_t* r)
+{
+  uint32_t u = walker_rng_u32(r);
+
+  if (search_shifts && (u & 0xf) == 0) {
+    uint32_t i = (u >> 4) % 5;
+    uint32_t s = d->s[i];
+
+    s = (u & 0x100) ? s+1 : s-1;
+
+    if (s-1 <= 62) d->s[i] = s;
+    return;
+  }
+
+  // flip one or two bits of one multiplier. never bit 0.
+  uint32_t w = (u >> 4) & 3;
+
+  d->m[w] ^= 2u << ((u >> 6) % 31);
+
+  if (u & (1u<<16))
+    d->m[w] ^= 2u << ((u >> 17) % 31);
+}
+
+void* walker_run(void* arg)
+{
+  walker_t*   w = (walker_t*)arg;
+  mix64_def_t cur;
+  double      score;
+  uint64_t    iter;
+  gof_t       gof;
+
+  pthread_mutex_lock(&walker_lock);
+  cur   = w->cur;
+  score = w->score;
+  iter  = w->iter;
+  pthread_mutex_unlock(&walker_lock);
+
+  if (!w->resumed) {
+    score = mix64_score(&cur, &gof, 0);
+    best_table_insert(&best_table, &cur, score);
+  }
+
+  while(!atomic_load_explicit(&search_stop, memory_order_relaxed)) {
+    if (search_iters && iter >= search_iters) break;
+
+    mix64_def_t next = cur;
+    mix64_propose(&next, &w->rng);
+
+    double s = mix64_score(&next, &gof, 0);
+    double t = search_t0 * pow(search_cool, (double)iter);
+
+    if ((s <= score) || (walker_rng_f64(&w->rng) < exp((score-s)/t))) {
+      cur   = next;
+      score = s;
+      best_table_insert(&best_table, &cur, score);
+    }
+
+    iter++;
+
+    pthread_mutex_lock(&walker_lock);
+    w->cur   = cur;
+    w->score = score;
+    w->iter  = iter;
+    pthread_mutex_unlock(&walker_lock);
+  }
+
+  return 0;
+}
+
+
+//-------------------------------------------------------------------
+// persistence. plain text so it can be hand edited/inspected:
+//
+//   id     <global id to resume from>
+//   walker <iter> <score> <def>
+//   best   <score> <def>
+//
+// written to a temp file and renamed over the original so a
+// kill at any point leaves either the old or the new table.
+
+bool search_save_file(const char* name)
+{
+  char  tmp[1024];
+  FILE* file;
+
+  snprintf(tmp, sizeof(tmp), "%s.tmp", name);
+
+  if ((file = fopen(tmp, "w")) == 0) {
+    fprintf(stderr, "error: couldn't open '%s'\n", tmp);
+    return false;
+  }
+
+  fprintf(file, "# vprng_mix lane search: s0 s1 s2 s3 s4 m0.lo m0.hi m1.lo m1.hi\n");
+  fprintf(file, "id %" PRIu64 "\n", vprng_global_id_get());
+
+  pthread_mutex_lock(&walker_lock);
+  for(uint32_t i=0; i<walker_count; i++) {
+    fprintf(file, "walker %" PRIu64 " %.17g ", walkers[i].iter, walkers[i].score);
+    mix64_def_print(file, &walkers[i].cur);
+    fprintf(file, "\n");
+  }
+  pthread_mutex_unlock(&walker_lock);
+
+  pthread_mutex_lock(&best_table.lock);
+  for(uint32_t i=0; i<best_table.n; i++) {
+    fprintf(file, "best %.17g ", best_table.e[i].score);
+    mix64_def_print(file, &best_table.e[i].def);
+    fprintf(file, "\n");
+  }
+  best_table.dirty = false;
+  pthread_mutex_unlock(&best_table.lock);
+
+  fflush(file);
+  fsync(fileno(file));
+  fclose(file);
+
+  if (rename(tmp, name) == 0) return true;
+
+  fprintf(stderr, "error: couldn't rename '%s'\n", tmp);
+  return false;
+}
+
+// returns number of walkers restored
+uint32_t search_load_file(const char* name, uint64_t* id)
+{
+  char     line[512];
+  uint32_t count = 0;
+  FILE*    file  = fopen(name, "r");
+
+  if (file == 0) return 0;
+
+  while(fgets(line, sizeof(line), file)) {
+    mix64_def_t def;
+    double      score;
+    uint64_t    iter;
+    int         n;
+
+    if (sscanf(line, "id %" SCNu64, id) == 1) continue;
+
+    if (sscanf(line, "walker %" SCNu64 " %lf %n", &iter, &score, &n) == 2) {
+      if (mix64_def_parse(line+n, &def) == 9 && mix64_def_valid(&def) && count < SEARCH_WALKER_MAX) {
+	walkers[count].cur     = def;
+	walkers[count].score   = score;
+	walkers[count].iter    = iter;
+	walkers[count].resumed = true;
+	count++;
+      }
+      continue;
+    }
+
+    if (sscanf(line, "best %lf %n", &score, &n) == 1) {
+      if (mix64_def_parse(line+n, &def) == 9 && mix64_def_valid(&def))
+	best_table_insert_i(&best_table, &def, score);
+      continue;
+    }
+  }
+
+  fclose(file);
+
+  return count;
+}
+
+void search_signal(int sig)
+{
+  (void)sig;
+  atomic_store(&search_stop, true);
+}
+
+void best_table_print(void)
+{
+  pthread_mutex_lock(&best_table.lock);
+  for(uint32_t i=0; i<best_table.n && i<16; i++) {
+    printf("  %2u: %.8f : ", i, best_table.e[i].score);
+    mix64_def_print(stdout, &best_table.e[i].def);
+    printf("\n");
+  }
+  pthread_mutex_unlock(&best_table.lock);
+}
+
+int search_run(const char* name)
+{
+  uint64_t id       = 1;
+  uint32_t restored = search_load_file(name, &id);
+  uint32_t n        = search_threads;
+
+  if (n == 0) n = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  if (n == 0) n = 1;
+  if (n > SEARCH_WALKER_MAX) n = SEARCH_WALKER_MAX;
+
+  // the walkers' random sequences are not resumed: the saved id only
+  // makes each vprng_init below draw a generator not used by the
+  // previous run(s)
+  vprng_global_id_set(id);
+
+  printf("search: %u walkers (%u resumed) : %u samples/candidate : table '%s'\n",
+	 n, restored < n ? restored : n, search_samples, name);
+
+  for(uint32_t i=0; i<n; i++) {
+    walker_t* w = walkers+i;
+
+    vprng_init(&w->rng.prng);
+    w->rng.i = 8;
+
+    if (i < restored) continue;
+
+    // new walkers: start from best table entries if any or
+    // from the current vprng_mix lanes.
+    if (best_table.n != 0)
+      w->cur = best_table.e[i % best_table.n].def;
+    else
+      mix64_def_current(&w->cur, i & 3);
+
+    w->iter    = 0;
+    w->resumed = false;
+  }
+
+  walker_count = n;
+
+  signal(SIGINT,  search_signal);
+  signal(SIGTERM, search_signal);
+
+  for(uint32_t i=0; i<n; i++)
+    pthread_create(&walkers[i].thread, 0, walker_run, walkers+i);
+
+  // periodic save until all walkers are done or a stop is requested
+  uint32_t elapsed = 0;
+  bool     done    = false;
+
+  while(!done) {
+    sleep(1);
+
+    done = atomic_load(&search_stop);
+
+    if (search_iters && !done) {
+      done = true;
+      pthread_mutex_lock(&walker_lock);
+      for(uint32_t i=0; i<n; i++) done &= walkers[i].iter >= search_iters;
+      pthread_mutex_unlock(&walker_lock);
+    }
+
+    if (++elapsed >= search_save || done) {
+      bool dirty;
+      
+      pthread_mutex_lock(&best_table.lock);
+      dirty = best_table.dirty;
+      pthread_mutex_unlock(&best_table.lock);
+      
+      elapsed = 0;
+      if (dirty) search_save_file(name);
+    }
+  }
+
+  atomic_store(&search_stop, true);
+
+  for(uint32_t i=0; i<n; i++)
+    pthread_join(walkers[i].thread, 0);
+
+  search_save_file(name);
+  best_table_print();
+
+  return 0;
+}
+
+// score each lane of the current vprng_mix (the bar to beat)
+void search_score_current(void)
+{
+  for(uint32_t l=0; l<4; l++) {
+    mix64_def_t def;
+    gof_t       gof;
+    double      mean;
+
+    mix64_def_current(&def, l);
+
+    double s = mix64_score(&def, &gof, &mean);
+
+    printf("lane %u: %.8f : |bias| = %10.8f : max = %f : chi = %f\n",
+	   l, s, mean*(1.0/100.0), gof.maxBias*(1.0/100.0), gof.perBitX2);
+  }
+}
+
+
+//-------------------------------------------------------------------
+
 void internal_error(char* msg, uint32_t code)
 {
   if (code != 0)
@@ -495,10 +1078,27 @@ void help_options(char* name)
   printf("\n"
 	 "hacky junk. integer arguments silently accept\n"
 	 "non-integer values and treat them like zero.\n"
+	 "\n"
+	 "vprng_mix lane search (FILE is the best-N table. resumes if it exists):\n"
+	 "  --threads=N  number of walkers (default: number of cores)\n"
+	 "  --iters=N    iterations per walker (default: until killed)\n"
+	 "  --samples=N  inputs per candidate score (default: %u)\n"
+	 "  --best=N     size of best-N table (default: %u)\n"
+	 "  --save=N     seconds between table saves (default: %u)\n"
+	 "  --shifts     allow shift amounts to be modified\n"
+	 "  --t0=X       initial annealing temperature (default: %g)\n"
+	 "  --cool=X     per iteration cooling factor (default: %g)\n"
+	 "  --score      score the current vprng_mix lanes and exit\n"
+	 "\n"
+	 "32-bit hash table (no FILE):\n"
+	 "  --table     score the 32-bit finalizer table\n"
+	 "  --examine   dump the LCG table and current finalizer constants\n"
 	 "  --inc       Weyl sequence increment     (32-bit, odd)\n"
 	 "  --state     Weyl sequence initial state (32-bit)\n"
+	 "  --phi       Weyl sequence increment = 1/phi\n"
 	 "  --help\n"
-	 "\n");
+	 "\n",
+	 search_samples, search_best, search_save, search_t0, search_cool);
 
   exit(0);
 }
@@ -511,43 +1111,34 @@ uint64_t parse_u64(char* str)
   return val;
 }
 
+double parse_f64(char* str)
+{
+  return strtod(str, NULL);
+}
+
 
 int main(int argc, char** argv)
 {
   uint32_t param_errors = 0;
+  uint32_t mode         = 0;
 
-  if (0) {
-    static const uint64_t k[] = {
-      0xd1342543de82ef95,   //   5*17*1277*2908441*47750621
-      0xaf251af3b0f025b5,   //   5*342349289*7372892873
-      0xb564ef22ec7aece5,   //   3^2*13*17*37*5101*34818615649
-      0xf7c2ebc08f67f2b5,   //   79*225988494748383163
-      0x27bb2ee687b0b0fd,   //   3*954311185259313919
-      0x369dea0f31a53f85,   //   3*5*262370600024666923
-    };
-
-    for(uint32_t i=0; i<6; i++) {
-      uint64_t v = k[i];
-      printf("%016lx ",v);
-      printb(v,64);
-      printf(" : %2u %2i\n", pop_64(v), bit_run_count_64(v));
-    }
-    return 0;
-  }
-
-  
-  examine_current(finalize_m0);
-  printf("\n");
-  examine_current(finalize_m1);
-  return 0;
-
+  enum { MODE_SEARCH, MODE_TABLE, MODE_EXAMINE, MODE_SCORE };
   
   static struct option long_options[] = {
-    {"inv",        no_argument,       0,  0},
-    {"seq",        no_argument,       0,  4},
     {"phi",        no_argument,       0, 'p'},
     {"inc",        required_argument, 0, 'i'},
     {"state",      required_argument, 0, 's'},
+    {"table",      no_argument,       0, 'T'},
+    {"examine",    no_argument,       0, 'e'},
+    {"score",      no_argument,       0, 'c'},
+    {"threads",    required_argument, 0, 't'},
+    {"iters",      required_argument, 0, 'n'},
+    {"samples",    required_argument, 0, 'N'},
+    {"best",       required_argument, 0, 'b'},
+    {"save",       required_argument, 0, 'S'},
+    {"shifts",     no_argument,       0, 'x'},
+    {"t0",         required_argument, 0, '0'},
+    {"cool",       required_argument, 0, 'C'},
     {"help",       optional_argument, 0, '?'},
     {0,            0,                 0,  0 }
   };
@@ -590,61 +1181,74 @@ int main(int argc, char** argv)
       }
     }
     break;
-    
-#if 0      
-    case 0: case 1: case 2:
-      {
-	uint64_t v = parse_u64(optarg);
-	v <<= (10*c);
-	if (v != 0)
-	  num_blocks = v;
-      }
-      break;
 
-    case 3: case 4: fill_type = (uint32_t)(c-3); break;
+    case 'T': mode = MODE_TABLE;   break;
+    case 'e': mode = MODE_EXAMINE; break;
+    case 'c': mode = MODE_SCORE;   break;
+    case 'x': search_shifts = true; break;
 
-    case 5: case 6: case 7:
-      sample_type = (uint32_t)(c-5);
+    case 't': search_threads = (uint32_t)parse_u64(optarg); break;
+    case 'n': search_iters   = parse_u64(optarg);           break;
+    case 'S': search_save    = (uint32_t)parse_u64(optarg); break;
+    case '0': search_t0      = parse_f64(optarg);           break;
+    case 'C': search_cool    = parse_f64(optarg);           break;
 
-      if (optarg) {
-	uint64_t v = parse_u64(optarg);
-	sample_state.inc = v|1;
+    case 'N': {
+      uint64_t v = parse_u64(optarg);
 
-	if ((v & 1)==0) {
-	  fprintf(stderr, "warning: increment must be odd. setting=0x%016lx\n", v|1); 
-	}
+      // round up to a full batch
+      v = (v + 4*SAC_BATCH-1) & ~(uint64_t)(4*SAC_BATCH-1);
+      
+      if (v != 0 && v <= 0x80000000) {
+	search_samples = (uint32_t)v;
       }
-      break;
-
-    case 'h':
-      if (optarg) {
-	bit_finalizer = get_hash(optarg);
-	break;
+      else {
+	print_error("--samples must be on [1,2^31]");
+	param_errors++;
       }
-      print_xorshift_mul_3();
-      return 0;
+    }
+    break;
+
+    case 'b': {
+      uint64_t v = parse_u64(optarg);
       
-    case 's': sample_state.state = parse_u64(optarg);  break;
-    case 'p': sample_state.inc   = 0x9e3779b97f4a7c15; break;
-    case '?': help_options(argv[0]);                   break;
-#endif      
+      if (v != 0 && v <= SEARCH_BEST_MAX) {
+	search_best = (uint32_t)v;
+      }
+      else {
+	print_error("--best must be on [1," VPRNG_STRINGIFY(SEARCH_BEST_MAX) "]");
+	param_errors++;
+      }
+    }
+    break;
+
+    case '?': help_options(argv[0]); break;
       
     default:
       printf("internal error: what option? %c (%u)\n", c,c);
     }
   }
 
-  if (param_errors) { } // yeah..something
-  
-  // all arguments should have been consumed
-  if (optind == argc) {
+  if (param_errors) return -1;
 
-    test_table();
-    
+  switch(mode) {
+  case MODE_TABLE:   test_table(); return 0;
+  case MODE_SCORE:   search_score_current(); return 0;
+
+  case MODE_EXAMINE:
+    examine_table();
+    printf("\n");
+    examine_current(vprng_finalize_m0);
+    printf("\n");
+    examine_current(vprng_finalize_m1);
     return 0;
+
+  default: break;
   }
 
-  
+  // all arguments but the table filename should have been consumed
+  if (optind == argc-1)
+    return search_run(argv[optind]);
   
   print_error("expected a single filename after the options");
 
@@ -5,6 +5,7 @@
 #include <stdalign.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 
 #if defined(__AVX2__)
@@ -65,6 +66,29 @@ uint32_t test_zero(uint64_t a)
 #endif
 
 #include "common.h"
+#include "vprng_gf2.h"
+#include "vprng_fill.h"
+#include "vprng_perm.h"
+#include "vprng_text.h"
+#include "vprng_uuid.h"
+
+#if !defined(VPRNG_STATE_EXTERNAL) || defined(VPRNG_POS_EXTERNAL)
+#include "vprng_matrix.h"
+#define CHECK_MATRIX
+#endif
+
+#if !defined(VPRNG_HIGHLANDER) && !defined(VPRNG_INIT_EXTRA)
+#include "vprng_pool.h"
+#define CHECK_POOL
+#endif
+
+#if defined(__unix__) && !defined(VPRNG_ADDITIVE_CONSTANT_EXTERN)
+#include <stdlib.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include "vprng_shm.h"
+#define CHECK_SHM
+#endif
 
 bool u64x4_eq(u64x4_t a, u64x4_t b)
 {
@@ -131,6 +155,7 @@ uint32_t check_basic(void)
   test_name("base weyl");
   errors += test_u64_eq(vprng_internal_inc_k*vprng_internal_inc_i,1);
 
+#if (VPRNG_STATE_WORDS == 1)
   // checking that the hobbled XorShift init values
   // are the next three after '1'.
   test_name("hobbled f2 init");
@@ -149,6 +174,7 @@ uint32_t check_basic(void)
     
     errors += test_zero(t);
   }
+#endif
   
 
   return errors;
@@ -156,21 +182,28 @@ uint32_t check_basic(void)
 
 uint32_t check_inv(vprng_t* prng)
 {
-  test_name("mix internal sanity:");
+  test_name("mix inverse:");
   
   // currently can handle modification the multiplicative
   // constants. compute the inverses here.
   u32x8_t i0 = mod_inverse_u32x8(vprng_finalize_m0);
   u32x8_t i1 = mod_inverse_u32x8(vprng_finalize_m1);
 
+  // and they must match the precomputed ones (vprng_unmix)
+  if (!u64x4_eq(vprng_cast_u64(i0), vprng_cast_u64(vprng_finalize_i0)) ||
+      !u64x4_eq(vprng_cast_u64(i1), vprng_cast_u64(vprng_finalize_i1)))
+    return test_fail();
+
   // would require tweaks to automatically handle any
   // changes of the xorshift constants.
   
   for(uint32_t i=0; i<33; i++) {
     u64x4_t u0 = prng->state;
     u64x4_t x  = vprng_u64x4(prng);
+
+    if (!u64x4_eq(u0, vprng_unmix(prng, vprng_cast_u32(x)))) return test_fail();
     
-    // start inverse
+    // start inverse (step by step reference)
     x = rxorshift_inv_64x4(x,32); // x ^= x >> 32(inverse)
     x = vprng_mix_mul(x, i0);
     x = rxorshift_inv_64x4(x,16); // x ^= x >> 16 (inverse)
@@ -189,6 +222,96 @@ uint32_t check_inv(vprng_t* prng)
 }
 
 
+#endif
+
+#if (VPRNG_VARIANT_ID == 2)
+// vpcg32: 32-bit lane finalizer
+uint32_t check_inv_vpcg32(void)
+{
+  vprng_t prng;
+  
+  test_name("mix inverse:");
+
+  u32x8_t i0 = mod_inverse_u32x8(vpcg_mul_m0);
+  u32x8_t i1 = mod_inverse_u32x8(vpcg_mul_m1);
+
+  if (!u64x4_eq(vprng_cast_u64(i0), vprng_cast_u64(vpcg_mul_i0)) ||
+      !u64x4_eq(vprng_cast_u64(i1), vprng_cast_u64(vpcg_mul_i1)))
+    return test_fail();
+
+  vprng_init(&prng);
+
+  for(uint32_t i=0; i<33; i++) {
+    u64x4_t u0 = prng.state;
+    u32x8_t x  = vprng_u32x8(&prng);
+
+    if (!u64x4_eq(u0, vprng_unmix(&prng, x))) return test_fail();
+  }
+
+  return test_pass();
+}
+#endif
+
+
+//*******************************************************************
+// hash API: batches match the single key forms for any position in
+// the batch, lane 0 is the generator's finalizer, MIX14 matches a
+// scalar version and the inverses recover the keys
+
+uint32_t check_hash(void)
+{
+  enum { N = 39 };
+  
+  uint64_t k[N+1], h[N], m[N];
+  uint64_t seed = UINT64_C(0x5851f42d4c957f2d);
+  uint32_t e    = 0;
+
+  test_name("hash:");
+
+  for(uint32_t i=0; i<=N; i++) k[i] = (uint64_t)i*i;
+
+  vprng_hash_batch(k+1, h, N, seed);
+  vprng_hash_mix14_batch(k+1, m, N, 0);
+  
+  for(uint32_t i=0; i<N; i++) {
+    e |= h[i] != vprng_hash_u64(k[i+1], seed);
+    e |= m[i] != vprng_hash_mix14_u64(k[i+1], 0);
+  }
+
+  u64x4_t v = {k[1], k[1], k[2], k[3]};
+  u64x4_t r = vprng_hash_u64x4(v);
+
+  e |= (r[0] != r[1]) | (r[2] != vprng_hash_u64(k[2],0)) | (r[2] == r[3]);
+  e |= r[0] != vprng_finalize(v)[0];
+  e |= vprng_hash_u64(k[1],seed) == vprng_hash_u64(k[1],0);
+
+  uint64_t x = k[5]^seed;
+
+  x ^= x >> 30; x *= UINT64_C(0x4be98134a5976fd3);
+  x ^= x >> 29; x *= UINT64_C(0x3bc0993a5ad19a13);
+  x ^= x >> 31;
+
+  e |= vprng_hash_mix14_u64(k[5],seed) != x;
+
+  // inverses (in-place)
+  vprng_unhash_batch(h, h, N, seed);
+  vprng_unhash_mix14_batch(m, m, N, 0);
+
+  for(uint32_t i=0; i<N; i++) e |= (h[i] != k[i+1]) | (m[i] != k[i+1]);
+
+  e |= vprng_unhash_u64(vprng_hash_u64(seed,1),1) != seed;
+  e |= !u64x4_eq(vprng_finalize_inv(vprng_finalize(v)), v);
+
+  return e ? test_fail() : test_pass();
+}
+
+
+//*******************************************************************
+// position in stream checks: variants with a custom state update
+// must supply matching position functions.
+
+#if !defined(VPRNG_STATE_EXTERNAL) || defined(VPRNG_POS_EXTERNAL)
+
 // spot check position in stream manipulation
 uint32_t check_pos(vprng_t* prng)
 {
@@ -214,11 +337,1037 @@ uint32_t check_pos(vprng_t* prng)
 
   return test_pass();
 }
+
+// large jumps must compose: set(p) + inc(q) = set(p+q) and must
+// match stepping.
+uint32_t check_pos_jump(vprng_t* prng)
+{
+  static const uint64_t p[] = {0x1, 0x2f3, 0x12345, 0x4e3779b9, 0x7fffffff};
+  
+  vprng_t a = *prng;
+  vprng_t b = *prng;
+
+  test_name("pos_inc:");
+
+  for(uint32_t i=0; i<LENGTHOF(p); i++) {
+    for(uint32_t j=0; j<LENGTHOF(p); j++) {
+      uint64_t t = p[i]+p[j];  // < 2^32 for 32-bit LCG variants
+      
+      vprng_pos_set(&a, p[i]);
+      vprng_pos_inc(&a, p[j]);
+      vprng_pos_set(&b, t);
+      
+      if (!u64x4_eq(a.state, b.state) || (vprng_pos_get(&a) != t))
+	return test_fail();
+    }
+  }
+
+  vprng_pos_set(&a, 1000);
+  vprng_pos_set(&b, 0);
+  
+  for(uint32_t i=0; i<1000; i++) vprng_u64x4(&b);
+  
+  if (!u64x4_eq(a.state, b.state)) return test_fail();
+
+  // per lane: each lane matches the scalar seek of that lane
+  u64x4_t pv = {p[1], p[4], 0, p[2]};
+  u64x4_t ov = {p[3], 0, p[0], p[2]};
+
+  vprng_pos_set_v(&a, pv);
+  vprng_pos_inc_v(&a, ov);
+
+  if (!u64x4_eq(vprng_pos_get_v(&a), pv+ov)) return test_fail();
+
+  for(uint32_t i=0; i<4; i++) {
+    vprng_pos_set(&b, pv[i]+ov[i]);
+    if (a.state[i] != b.state[i]) return test_fail();
+  }
+
+  return test_pass();
+}
+
+// lane streams: each lane's stream must be that lane of the vector
+// generator regardless of how the other lanes are consumed. lanes
+// are independently seekable.
+uint32_t check_lanes(vprng_t* prng)
+{
+  enum { N = 100, P = 12345 };
+  
+  static u64x4_t r64[N];
+  static u32x8_t r32[N];
+  
+  vprng_lanes64_t l64;
+  vprng_lanes32_t l32;
+  vprng_t         a = *prng;
+  uint32_t        c[8] = {0};
+
+  test_name("lane streams:");
+
+  vprng_pos_set(&a, P);
+  vprng_lanes64_init(&l64, &a);
+  vprng_lanes32_init(&l32, &a);
+  
+  for(uint32_t i=0; i<N; i++) r64[i] = vprng_u64x4(&a);
+
+  vprng_pos_set(&a, P);
+  for(uint32_t i=0; i<N; i++) r32[i] = vprng_u32x8(&a);
+
+  // irregular consumption: lane 'i' pulls on steps that are multiple of (i+1)
+  for(uint32_t t=0; t<N; t++) {
+    for(uint32_t i=0; i<8; i++) {
+      if (t % (i+1)) continue;
+
+      if (i < 4 && vprng_lanes64_next(&l64,i) != r64[c[i]][i]) return test_fail();
+      if (vprng_lanes32_next(&l32,i) != r32[c[i]][i])          return test_fail();
+      c[i]++;
+    }
+  }
+
+  for(uint32_t i=0; i<8; i++) {
+    if (i < 4 && vprng_lanes64_pos_get(&l64,i) != P+c[i]) return test_fail();
+    if (vprng_lanes32_pos_get(&l32,i) != P+c[i])          return test_fail();
+  }
+
+  // seek lane 2 only: others continue
+  vprng_lanes64_pos_set(&l64, 2, P+3);
+  vprng_lanes32_pos_set(&l32, 5, P+3);
+
+  if (vprng_lanes64_next(&l64,2) != r64[3][2])       return test_fail();
+  if (vprng_lanes64_next(&l64,1) != r64[c[1]][1])    return test_fail();
+  if (vprng_lanes32_next(&l32,5) != r32[3][5])       return test_fail();
+  if (vprng_lanes32_next(&l32,4) != r32[c[4]][4])    return test_fail();
+
+  // single lane get/set on a generator
+  vprng_pos_set(&a, P);
+  vprng_lane_pos_set(&a, 1, 77);
+  
+  if (vprng_lane_pos_get(&a,1) != 77)  return test_fail();
+  if (vprng_lane_pos_get(&a,3) != P)   return test_fail();
+  if (vprng_pos_get(&a)        != P)   return test_fail();
+
+  return test_pass();
+}
+#endif
+
+
+//*******************************************************************
+// F2 (second state) jumps vs. stepping and jumps must compose
+
+uint32_t check_f2_jump(void)
+{
+  static const uint64_t p[] = {0x1, 0x2f3, 0x12345, UINT64_C(0x7e3779b97f4a7c15)};
+  
+  u64x4_t a[VPRNG_STATE_WORDS];
+  u64x4_t b[VPRNG_STATE_WORDS];
+
+  test_name("f2 jump:");
+
+  // carry-less product vs. software (same if no hardware support)
+  for(uint32_t i=0; i<LENGTHOF(p); i++) {
+    uint64_t h0,h1;
+    uint64_t x = p[i]*UINT64_C(0xd1342543de82ef95);
+    uint64_t l0 = vprng_clmul64   (p[i],x,&h0);
+    uint64_t l1 = vprng_clmul64_sw(p[i],x,&h1);
+    
+    if ((l0 != l1) || (h0 != h1)) return test_fail();
+  }
+
+  cvprng_f2_init(a);
+  cvprng_f2_init(b);
+  cvprng_f2_jump(a, 1000);
+
+  for(uint32_t i=0; i<1000; i++) cvprng_state_up_w(b);
+
+  if (memcmp(a,b,sizeof(a)) != 0) return test_fail();
+
+  for(uint32_t i=0; i<LENGTHOF(p); i++) {
+    for(uint32_t j=0; j<LENGTHOF(p); j++) {
+      cvprng_f2_init(a); cvprng_f2_jump(a, p[i]); cvprng_f2_jump(a, p[j]);
+      cvprng_f2_init(b); cvprng_f2_jump(b, p[i]+p[j]);
+      
+      if (memcmp(a,b,sizeof(a)) != 0) return test_fail();
+    }
+  }
+  
+  return test_pass();
+}
+
+
+//*******************************************************************
+// batch init must match sequential (single thread) including the
+// global id after (unused reserved ids are returned)
+
+#if !defined(VPRNG_ADDITIVE_CONSTANT_EXTERN)
+uint32_t check_init_n(void)
+{
+  enum { N = 37 };
+  
+  static cvprng_t a[N], b[N];
+  static vprng_t  c[N];
+
+  test_name("init_n:");
+
+  for(uint32_t n=0; n<N; n += 6) {
+    vprng_global_id_set(0x1234+n);
+    for(uint32_t i=0; i<n; i++) cvprng_init(a+i);
+    uint64_t id = vprng_global_id_get();
+    
+    vprng_global_id_set(0x1234+n);
+    cvprng_init_n(b,n);
+    if (id != vprng_global_id_get()) return test_fail();
+    
+    vprng_global_id_set(0x1234+n);
+    vprng_init_n(c,n);
+    if (id != vprng_global_id_get()) return test_fail();
+
+    for(uint32_t i=0; i<n; i++) {
+      if (memcmp(a+i,b+i,sizeof(cvprng_t)) != 0)     return test_fail();
+      if (memcmp(&a[i].base,c+i,sizeof(vprng_t)) != 0) return test_fail();
+    }
+  }
+  
+  return test_pass();
+}
+
+// direct init from an index must match sequential
+uint32_t check_init_index(void)
+{
+  enum { N = 5000 };
+
+  static vprng_t  a[N];
+  static uint32_t count[4*N/VPRNG_INDEX_BLOCK+8];
+  
+  vprng_index_t index;
+  cvprng_t      c;
+  
+  test_name("init_index:");
+
+  if (vprng_index_entries(N) > LENGTHOF(count)) return test_fail();
+  
+  vprng_global_id_set(0x1234);
+  vprng_init_n(a,N);
+  vprng_index_init(&index, count, N, 0x1234);
+
+  for(uint32_t k=0; k<N; k++) {
+    vprng_t p;
+    vprng_init_index(&p, &index, k);
+    if (memcmp(a+k,&p,sizeof(p)) != 0) return test_fail();
+  }
+
+  cvprng_init_index(&c, &index, N-1);
+  
+  if (memcmp(a+N-1,&c.base,sizeof(vprng_t)) != 0) return test_fail();
+  
+  return test_pass();
+}
+
+// thread id leases & fixed ranges (single thread): must match the
+// global counter and leave it as if not used (lease) or untouched
+// (fixed range)
+uint32_t check_thread_ids(void)
+{
+  enum { N = 40 };
+
+  static vprng_t a[N], b[N];
+  
+  test_name("thread ids:");
+
+  vprng_global_id_set(0x1234);
+  for(uint32_t i=0; i<N; i++) vprng_init(a+i);
+  uint64_t id = vprng_global_id_get();
+
+  // 16 id leases: mix of single, batch and exhausting leases
+  vprng_global_id_set(0x1234);
+  vprng_thread_id_lease(4);
+  for(uint32_t i=0; i<3; i++) vprng_init(b+i);
+  vprng_init_n(b+3,N-3);
+  vprng_thread_id_release();
+
+  if (memcmp(a,b,sizeof(a)) != 0)    return test_fail();
+  if (id != vprng_global_id_get())   return test_fail();
+
+  // fixed range
+  vprng_global_id_set(7);
+  vprng_thread_id_range(0x1234, 2*4*N);
+  vprng_init_n(b,N-5);
+  for(uint32_t i=N-5; i<N; i++) vprng_init(b+i);
+  vprng_thread_id_release();
+
+  if (memcmp(a,b,sizeof(a)) != 0)    return test_fail();
+  if (vprng_global_id_get() != 7)    return test_fail();
+
+  return test_pass();
+}
+
+#if !defined(VPRNG_HIGHLANDER)
+// split & derive: reproducible, distinct and must not touch the
+// global counter
+uint32_t check_split(void)
+{
+  static const uint64_t path[] = {3,1,4,1,5};
+
+  vprng_t  r,p0,p1,a,b;
+  cvprng_t c0,c1,d0,d1;
+  
+  test_name("split/derive:");
+
+  vprng_global_id_set(0x1234);
+  vprng_init(&r);
+  cvprng_init(&c0);
+  c1 = c0;
+
+  uint64_t id = vprng_global_id_get();
+  
+  // split: same parent & sequence gives same children
+  p0 = r; p1 = r;
+  vprng_split(&p0,&a); vprng_split(&p1,&b);
+  if (memcmp(&a,&b,sizeof(a)) != 0)              return test_fail();
+  if (memcmp(&p0,&p1,sizeof(a)) != 0)            return test_fail();
+  vprng_split(&p0,&b);
+  if (a.inc[0] == b.inc[0])                      return test_fail();
+  if (vprng_pos_get(&a) != 0)                    return test_fail();
+
+  cvprng_split(&c0,&d0); cvprng_split(&c1,&d1);
+  if (memcmp(&d0,&d1,sizeof(d0)) != 0)           return test_fail();
+  
+  // derive: depends only on root and path
+  vprng_derive(&a,&r,path,LENGTHOF(path));
+  vprng_derive(&b,&a,path,0);
+  if (memcmp(&a,&b,sizeof(a)) != 0)              return test_fail();
+  vprng_derive(&b,&r,path,2);
+  vprng_derive(&b,&b,path+2,LENGTHOF(path)-2);
+  if (memcmp(&a,&b,sizeof(a)) != 0)              return test_fail();
+  vprng_derive(&b,&r,path,LENGTHOF(path)-1);
+  if (a.inc[0] == b.inc[0])                      return test_fail();
+
+  cvprng_derive(&d0,&c0,path,3);
+  cvprng_derive(&d1,&c0,path,3);
+  if (memcmp(&d0,&d1,sizeof(d0)) != 0)           return test_fail();
+  
+  if (id != vprng_global_id_get())               return test_fail();
+  
+  return test_pass();
+}
+#endif
+
+#if defined(CHECK_SHM)
+// draining a small fixed range must abort (even with NDEBUG) instead
+// of falling back to the global counter. run in a child process
+uint32_t check_thread_id_exhausted(void)
+{
+  int status;
+
+  test_name("thread id range exhausted:");
+
+  fflush(stdout);
+  
+  pid_t pid = fork();
+
+  if (pid < 0) return test_fail();
+
+  if (pid == 0) {
+    vprng_t a;
+    
+    freopen("/dev/null", "w", stderr);
+    vprng_global_id_set(7);
+    vprng_thread_id_range(0x1234, 16);
+    
+    for(uint32_t i=0; i<16; i++) vprng_init(&a);
+    
+    _exit(0);
+  }
+
+  if (waitpid(pid, &status, 0) != pid)                    return test_fail();
+  if (!WIFSIGNALED(status) || WTERMSIG(status) != SIGABRT) return test_fail();
+
+  return test_pass();
+}
+
+// file backed shared id counter: a second mapping (stand-in for
+// another process) must see the reservations of the first, can't
+// be reset and closing returns to the process local counter
+uint32_t check_shm(void)
+{
+  char        path[] = "/tmp/vprng_shm_XXXXXX";
+  int         fd     = mkstemp(path);
+  vprng_shm_t s0, s1;
+  vprng_t     a[8];
+  uint32_t    r      = 1;
+  
+  test_name("shm id counter:");
+
+  if (fd < 0) return test_fail();
+  
+  close(fd);
+  vprng_global_id_set(7);
+
+  if (vprng_shm_file(&s0, path) == 0) {
+    // creator sets the initial id. setting is ignored while bound
+    vprng_global_id_set(1234);
+    
+    if (vprng_global_id_get() == VPRNG_SHM_ID_INIT) {
+      uint64_t id;
+      
+      vprng_init_n(a,8);
+      id = vprng_global_id_get();
+
+      if (id >= 32 && vprng_shm_file(&s1, path) == 0) {
+	r = vprng_global_id_get() != id;
+	vprng_init(a);
+	r |= s0.seg->id != vprng_global_id_get();
+	r |= vprng_shm_sync(&s1) != 0;
+	vprng_shm_close(&s1);
+      }
+    }
+    vprng_shm_close(&s0);
+    r |= vprng_global_id_get() != 7;
+  }
+  
+  unlink(path);
+
+  return r ? test_fail() : test_pass();
+}
+#endif
+#endif
+
+
+//*******************************************************************
+// SoA pool: must match the individual generators
+
+#if defined(CHECK_POOL)
+uint32_t check_pool(void)
+{
+  enum { N = 70 };
+  
+  static cvprng_t a[N];
+  vprng_pool_t    pool;
+  u32x8_t         r[N];
+  uint32_t        e = 0;
+  
+  test_name("pool:");
+
+  for(uint32_t f=0; f<4; f++) {
+    vprng_global_id_set(0x1234);
+
+#if defined(VPRNG_STATE_EXTERNAL) && !defined(VPRNG_POS_EXTERNAL)
+    // no positions: shared mode must be rejected
+    if (f & VPRNG_POOL_SHARED) {
+      if (vprng_pool_init(&pool, N, f) == 0) return test_fail();
+      continue;
+    }
+#endif
+    
+    if (vprng_pool_init(&pool, N, f) != 0) return test_fail();
+    
+    // expected generators
+    vprng_global_id_set(0x1234);
+    
+    if (f & VPRNG_POOL_SHARED) {
+      cvprng_t t;
+      cvprng_init(&t);
+      for(uint32_t i=0; i<N; i++) {
+	a[i] = t;
+	cvprng_pos_set(a+i, (uint64_t)i << pool.shift);
+      }
+    }
+    else
+      for(uint32_t i=0; i<N; i++) cvprng_init(a+i);
+
+    // two steps of a sub-range then all
+    for(uint32_t k=0; k<3; k++) {
+      uint32_t first = (k < 2) ? 3  : 0;
+      uint32_t count = (k < 2) ? 50 : N;
+      
+      if (f & VPRNG_POOL_COMBINED) {
+	cvprng_pool_step_u32(&pool, first, count, r);
+	for(uint32_t i=0; i<count; i++)
+	  e |= !u64x4_eq(vprng_cast_u64(r[i]), cvprng_u64x4(a+first+i));
+      }
+      else {
+	vprng_pool_step_u32(&pool, first, count, r);
+	for(uint32_t i=0; i<count; i++)
+	  e |= !u64x4_eq(vprng_cast_u64(r[i]), vprng_u64x4(&a[first+i].base));
+      }
+    }
+    
+    vprng_pool_free(&pool);
+  }
+  
+  return e ? test_fail() : test_pass();
+}
 #endif
 
 
-int main(void)
+//*******************************************************************
+// strided/2D/scatter fills: element 'i' is value 'i' of a contiguous
+// fill (and no writes outside of the destination elements)
+
+uint32_t check_fill(void)
 {
+  enum { N = 61, S = 3, R = 7, C = 9, P = 13 };
+
+  static uint32_t r32[N+8];
+  static uint32_t d32[N*S];
+  static double   r64[N+4];
+  static double   d64[N*S];
+  static uint32_t idx[N];
+  
+  vprng_t  prng;
+  vprng_t  a, b;
+  uint32_t e = 0;
+
+  test_name("fill:");
+
+  vprng_init(&prng);
+  a = b = prng;
+
+  vprng_block_fill_u32((N+7)/8, (u32x8_t*)r32, &a);
+  
+  memset(d32, 0, sizeof(d32));
+  vprng_fill_u32_strided(&b, d32, N, S);
+  
+  for(uint32_t i=0; i<N*S; i++)
+    e |= d32[i] != ((i % S) ? 0 : r32[i/S]);
+
+  // rows of a C wide sub-matrix with row pitch P
+  b = prng;
+  memset(d32, 0, sizeof(d32));
+  vprng_fill_u32_2d(&b, d32, R, C, P);
+
+  for(uint32_t i=0; i<R*P; i++)
+    e |= d32[i] != (((i%P) < C) ? r32[(i/P)*C + (i%P)] : 0);
+
+  // scatter: reversed odd positions
+  for(uint32_t i=0; i<N; i++) idx[i] = 2*(N-1-i)+1;
+
+  a = b = prng;
+  
+  for(uint32_t i=0; i<(N+3)/4; i++) {
+    f64x4_t v = vprng_f64x4(&a);
+    memcpy(r64+4*i, &v, sizeof(v));
+  }
+
+  memset(d64, 0, sizeof(d64));
+  vprng_fill_f64_scatter(&b, d64, N, idx);
+
+  for(uint32_t i=0; i<N; i++) e |= (d64[idx[i]] != r64[i]) | (d64[idx[i]-1] != 0.0);
+
+  e |= !u64x4_eq(a.state, b.state);
+  
+  return e ? test_fail() : test_pass();
+}
+
+
+//*******************************************************************
+// random matrices: layout independent, tiles regenerate the same values
+// and basic statistics of the entries
+
+#if defined(CHECK_MATRIX)
+uint32_t check_matrix(void)
+{
+  enum { R = 200, C = 150, TR = VPRNG_MATRIX_TILE_ROWS, TC = VPRNG_MATRIX_TILE_COLS };
+
+  static float  a[R*C], b[R*C], t[TR*TC];
+  static double d[R*C];
+  
+  vprng_matrix_t m;
+  vprng_t        prng;
+  uint32_t       e = 0;
+
+  test_name("matrix:");
+
+  vprng_init(&prng);
+  vprng_u32x8(&prng);
+
+  vprng_matrix_init(&m, &prng, R, C, VPRNG_MATRIX_RADEMACHER, 0.5);
+  vprng_matrix_fill_f32(&m, a, C, VPRNG_MATRIX_ROW_MAJOR);
+  vprng_matrix_fill_f32(&m, b, R, VPRNG_MATRIX_COL_MAJOR);
+
+  for(uint32_t r=0; r<R; r++)
+    for(uint32_t c=0; c<C; c++)
+      e |= (a[r*C+c] != b[c*R+r]) | (fabsf(a[r*C+c]) != 0.5f);
+
+  // an edge tile on its own
+  vprng_matrix_tile_f32(&m, 1, 2, t, TC, VPRNG_MATRIX_ROW_MAJOR);
+
+  for(uint32_t r=TR; r<R && r<2*TR; r++)
+    for(uint32_t c=2*TC; c<C; c++)
+      e |= a[r*C+c] != t[(r-TR)*TC + (c-2*TC)];
+
+  // zero fraction is 2/3 (+/- ~4 sigma)
+  uint32_t z = 0;
+
+  vprng_matrix_init(&m, &prng, R, C, VPRNG_MATRIX_ACHLIOPTAS, 1.0);
+  vprng_matrix_fill_f32(&m, a, C, VPRNG_MATRIX_ROW_MAJOR);
+
+  for(uint32_t i=0; i<R*C; i++) {
+    z += (a[i] == 0.f);
+    e |= (a[i] != 0.f) & (fabsf(a[i]) != (float)sqrt(3.0));
+  }
+
+  e |= (z < (uint32_t)(0.656*R*C)) | (z > (uint32_t)(0.678*R*C));
+
+  // gaussian: mean and variance
+  seq_stats_t s;
+  
+  vprng_matrix_init(&m, &prng, R, C, VPRNG_MATRIX_GAUSSIAN, 1.0);
+  vprng_matrix_fill_f64(&m, d, C, VPRNG_MATRIX_ROW_MAJOR);
+  seq_stats_init(&s);
+  
+  for(uint32_t i=0; i<R*C; i++) seq_stats_add(&s, d[i]);
+
+  e |= (fabs(seq_stats_mean(&s)) > 0.025) | (fabs(seq_stats_variance(&s)-1.0) > 0.04);
+
+  return e ? test_fail() : test_pass();
+}
+#endif
+
+
+//*******************************************************************
+// memoryless permutations: are permutations (all sizes of a
+// range of widths), batch matches the single form & keys matter
+
+uint32_t check_perm(void)
+{
+  enum { N = 5000 };
+
+  static uint8_t  seen[N];
+  static uint64_t p[N];
+  
+  vprng_perm_t perm, alt;
+  vprng_t      prng;
+  uint32_t     e = 0;
+
+  test_name("perm:");
+
+  vprng_init(&prng);
+
+  for(uint32_t n=1; n<=N; n = 3*n+1) {
+    vprng_perm_init(&perm, &prng, n);
+    vprng_perm_batch(&perm, 0, n, p);
+    memset(seen, 0, n);
+
+    for(uint32_t i=0; i<n; i++) {
+      e |= (p[i] >= n);
+      if (p[i] < n) { e |= seen[p[i]]; seen[p[i]] = 1; }
+      e |= p[i] != vprng_perm_at(&perm, i);
+    }
+  }
+
+  // partial batch (from an offset) and key dependence
+  vprng_perm_init(&alt, &prng, N);
+  vprng_perm_batch(&alt, 7, 13, p);
+
+  for(uint32_t i=0; i<13; i++) e |= p[i] != vprng_perm_at(&alt, i+7);
+
+  vprng_perm_init(&perm, &prng, N);
+  
+  uint32_t same = 0;
+  for(uint32_t i=0; i<64; i++) same += vprng_perm_at(&perm,i) == vprng_perm_at(&alt,i);
+
+  e |= same > 4;
+
+  // full width
+  vprng_perm_init(&perm, &prng, UINT64_C(0xffffffffffffffff));
+  e |= vprng_perm_at(&perm, 1) == vprng_perm_at(&perm, 2);
+  
+  return e ? test_fail() : test_pass();
+}
+
+
+//*******************************************************************
+// random text: matches scalar conversions of the raw bytes and the
+// alphabet form is roughly uniform (and handles rejection)
+
+uint32_t check_text(void)
+{
+  enum { N = 1000 };
+  
+  static const char hex[] = "0123456789abcdef";
+  static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+  static const char dec[] = "0123456789";
+  
+  static uint8_t b[2*N];
+  static char    t[2*N+1];
+  
+  vprng_t  prng, a;
+  uint32_t c[10] = {0};
+  uint32_t e     = 0;
+
+  test_name("text:");
+
+  vprng_init(&prng);
+
+  // hex: 32 low nibbles then 32 high nibbles per step
+  a = prng;
+  vprng_text_bytes(&a, b, 2*N);
+  a = prng;
+  vprng_text_hex(&a, t, 2*N-5);
+
+  for(uint32_t i=0; i<2*N-5; i++) {
+    uint8_t v = b[(i>>6)*32 + (i & 31)];
+    e |= t[i] != hex[(i & 32) ? v >> 4 : v & 0xf];
+  }
+
+  a = prng;
+  vprng_text_base64url(&a, t, N-3);
+
+  for(uint32_t i=0; i<N-3; i++) e |= t[i] != b64[b[i] & 0x3f];
+
+  // unbiased mapping: expected N/5 of each
+  memset(t, 0, sizeof(t));
+  a = prng;
+  vprng_text_alphabet(&a, t, 2*N, dec, 10);
+
+  for(uint32_t i=0; i<2*N; i++) {
+    uint32_t d = (uint32_t)(t[i]-'0');
+    if (d < 10) c[d]++; else e = 1;
+  }
+
+  for(uint32_t i=0; i<10; i++) e |= (c[i] < 140) | (c[i] > 260);
+
+  vprng_text_alphabet(&a, t, 7, "x", 1);
+  e |= memcmp(t, "xxxxxxx", 7) != 0;
+  
+  return e ? test_fail() : test_pass();
+}
+
+
+//*******************************************************************
+// UUIDs: fixed fields set, all other bits are the raw output and the
+// text form matches printf
+
+uint32_t check_uuid(void)
+{
+  enum { N = 7 };
+  
+  static const uint8_t m4[16] = {0,0,0,0, 0,0,0xf0,0, 0xc0,0,0,0, 0,0,0,0};
+  
+  vprng_uuid_t u[N];
+  uint8_t      b[(N+1)*16];
+  char         t[N*37+1], r[40];
+  uint64_t     ms = UINT64_C(0x018f3a2b4c5d);
+  vprng_t      prng, a;
+  uint32_t     e = 0;
+
+  test_name("uuid:");
+
+  vprng_init(&prng);
+
+  a = prng; vprng_text_bytes(&a, b, sizeof(b));
+  a = prng; vprng_uuid_v4_fill(&a, u, N);
+
+  for(uint32_t i=0; i<N; i++) {
+    e |= ((u[i].b[6] >> 4) != 4) | ((u[i].b[8] >> 6) != 2);
+    for(uint32_t j=0; j<16; j++) e |= (u[i].b[j] ^ b[16*i+j]) & ~m4[j];
+  }
+
+  a = prng; vprng_uuid_v7_fill(&a, u, N, ms);
+
+  for(uint32_t i=0; i<N; i++) {
+    uint64_t v = 0;
+    for(uint32_t j=0; j<6; j++) v = (v << 8) | u[i].b[j];
+    e |= (v != ms) | ((u[i].b[6] >> 4) != 7) | ((u[i].b[8] >> 6) != 2);
+    for(uint32_t j=6; j<16; j++) e |= (u[i].b[j] ^ b[16*i+j]) & ~m4[j];
+  }
+
+  vprng_uuid_format_n(t, u, N, '\n');
+
+  for(uint32_t i=0; i<N; i++) {
+    const uint8_t* x = u[i].b;
+    snprintf(r, sizeof(r),
+	     "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x\n",
+	     x[0],x[1],x[2],x[3],x[4],x[5],x[6],x[7],x[8],x[9],x[10],x[11],x[12],x[13],x[14],x[15]);
+    e |= memcmp(t+37*i, r, 37) != 0;
+  }
+  
+  return e ? test_fail() : test_pass();
+}
+
+
+//*******************************************************************
+// GF(2) matrix module: M4RM product vs. naive, powers and jump
+// tables vs. stepping an xorshift (10,7,33)
+
+static uint64_t gf2_xorshift(uint64_t x)
+{
+  x ^= x << 10;
+  x ^= x >>  7;
+  x ^= x << 33;
+  return x;
+}
+
+uint32_t check_gf2(void)
+{
+  static const uint64_t p[] = {0x1, 0x2f3, 0x12345, UINT64_C(0x7e3779b97f4a7c15)};
+
+  vprng_gf2_mat_t  m,a,b;
+  vprng_gf2_jump_t j;
+
+  test_name("gf2 matrix:");
+
+  vprng_gf2_from_func(&m, gf2_xorshift);
+
+  if (vprng_gf2_rank(&m) != 64) return test_fail();
+
+  // product vs. naive: row 'i' of AB is the XOR of rows of B
+  // selected by row 'i' of A
+  vprng_gf2_pow(&a,&m,0x1234);
+  vprng_gf2_mul(&b,&a,&m);
+
+  for(uint32_t i=0; i<64; i++) {
+    uint64_t r = 0;
+    for(uint32_t k=0; k<64; k++)
+      if ((a.r[i] >> k) & 1) r ^= m.r[k];
+    if (r != b.r[i]) return test_fail();
+  }
+
+  // transpose is an involution
+  a = b; vprng_gf2_transpose(&a); vprng_gf2_transpose(&a);
+
+  if (memcmp(&a,&b,sizeof(a)) != 0) return test_fail();
+
+  // power and jump vs. stepping
+  vprng_gf2_pow(&a,&m,1000);
+  vprng_gf2_jump_init(&j,&m);
+
+  uint64_t x = 1;
+  for(uint32_t i=0; i<1000; i++) x = gf2_xorshift(x);
+
+  if (vprng_gf2_apply(&a,1)     != x) return test_fail();
+  if (vprng_gf2_jump(&j,1,1000) != x) return test_fail();
+
+  // jumps must compose
+  for(uint32_t i=0; i<LENGTHOF(p); i++) {
+    u64x4_t v = {1,2,3,4};
+    u64x4_t r = vprng_gf2_jump_x4(&j, vprng_gf2_jump_x4(&j,v,p[i]), 0x2f3);
+
+    vprng_gf2_pow(&a,&m,p[i]+0x2f3);
+
+    for(uint32_t k=0; k<4; k++)
+      if (r[k] != vprng_gf2_apply(&a,v[k])) return test_fail();
+  }
+  
+  return test_pass();
+}
+
+
+//*******************************************************************
+// serialization round trip (all variants). not all variants are
+// representable in which case it's reported and skipped
+
+uint32_t check_serialize(void)
+{
+  enum { N = 16 };
+  
+  static vprng_t  v[N], vr[N];
+  static cvprng_t c[N], cr[N];
+  static uint8_t  d[N*VPRNG_SERIAL_BYTES];
+
+  for(uint32_t i=0; i<N; i++) {
+    vprng_init(v+i);
+    cvprng_init(c+i);
+    
+    // walk to some differing positions
+    for(uint32_t j=0; j<(i*i*7); j++) { vprng_u64x4(v+i); cvprng_u64x4(c+i); }
+  }
+
+  test_name("vprng serialize:");
+  
+  if (vprng_serialize_n(N, d, v) == N) {
+    if ((vprng_deserialize_n(N, vr, d) != N) || memcmp(v, vr, sizeof(v)) != 0)
+      return test_fail();
+
+    // variant/type tag mismatch must be rejected
+    if (cvprng_deserialize(cr, d) != 0)
+      return test_fail();
+    
+    test_pass();
+  }
+  else printf(WARNING "not representable" ENDC "\n");
+  
+  test_name("cvprng serialize:");
+  
+  if (cvprng_serialize_n(N, d, c) == N) {
+    if ((cvprng_deserialize_n(N, cr, d) != N) || memcmp(c, cr, sizeof(c)) != 0)
+      return test_fail();
+    
+    // should continue as if never stored
+    for(uint32_t j=0; j<64; j++)
+      if (!u64x4_eq(cvprng_u64x4(c+N-1), cvprng_u64x4(cr+N-1)))
+	return test_fail();
+
+    test_pass();
+  }
+  else printf(WARNING "not representable" ENDC "\n");
+
+  return 0;
+}
+
+
+//*******************************************************************
+// known-answer vectors and streaming digest (all variants)
+//
+// both vprng & cvprng are initialized with the global id set to
+// KAT_ID so the additive constant selection is covered as well.
+// The KAT entries are the first KAT_LEN results and the digest
+// is a hash of the first KAT_DIGEST_BYTES of output. Any change
+// that's supposed to be bit-exact (unrolling, dispatch, ISA
+// specific paths, etc) must reproduce both. A new or modified
+// variant can dump its entry for kat.h with: self_check --kat
+
+#define KAT_ID           UINT64_C(0x5eed)
+#define KAT_DIGEST_BYTES (UINT64_C(1)<<30)
+
+#include "kat.h"
+
+static const uint64_t kat_digest_k = UINT64_C(0xd1342543de82ef95);
+
+// bijective per input so any single difference in the stream
+// survives to the end
+static inline u64x4_t kat_digest_step(u64x4_t h, u64x4_t v)
+{
+  h ^= v; h *= kat_digest_k; h ^= h >> 32;
+  return h;
+}
+
+// four independent chains to not be latency bound
+#define KAT_DIGEST(NAME, TYPE, NEXT)                            \
+static u64x4_t NAME(TYPE* prng)                                 \
+{                                                               \
+  u64x4_t  h0 = {0}, h1 = {1}, h2 = {2}, h3 = {3};              \
+  uint64_t n  = KAT_DIGEST_BYTES/(4*sizeof(u64x4_t));           \
+                                                                \
+  for(uint64_t i=0; i<n; i++) {                                 \
+    h0 = kat_digest_step(h0, NEXT(prng));                       \
+    h1 = kat_digest_step(h1, NEXT(prng));                       \
+    h2 = kat_digest_step(h2, NEXT(prng));                       \
+    h3 = kat_digest_step(h3, NEXT(prng));                       \
+  }                                                             \
+                                                                \
+  h0 = kat_digest_step(h0, h1);                                 \
+  h0 = kat_digest_step(h0, h2);                                 \
+  h0 = kat_digest_step(h0, h3);                                 \
+                                                                \
+  return h0;                                                    \
+}
+
+KAT_DIGEST( vprng_digest,  vprng_t,  vprng_u64x4)
+KAT_DIGEST(cvprng_digest, cvprng_t, cvprng_u64x4)
+
+static const kat_t* kat_find(void)
+{
+  for(uint32_t i=0; i<LENGTHOF(kat_table); i++)
+    if ((strcmp(kat_table[i].name, VPRNG_NAME) == 0) &&
+	((kat_table[i].words ? kat_table[i].words : 1) == VPRNG_STATE_WORDS))
+      return kat_table+i;
+
+  return NULL;
+}
+
+static void kat_fixed_init(vprng_t* prng, cvprng_t* cprng)
+{
+  vprng_global_id_set(KAT_ID);  vprng_init(prng);
+  vprng_global_id_set(KAT_ID); cvprng_init(cprng);
+}
+
+static uint32_t kat_vectors(const u64x4_t* expect, u64x4_t (*next)(void*), void* prng)
+{
+  for(uint32_t i=0; i<KAT_LEN; i++) {
+    u64x4_t v = next(prng);
+    if (u64x4_eq(expect[i], v)) continue;
+    dump2_u64x4(expect[i], v);
+    return test_fail();
+  }
+  return test_pass();
+}
+
+static u64x4_t kat_next_v(void* p) { return  vprng_u64x4(( vprng_t*)p); }
+static u64x4_t kat_next_c(void* p) { return cvprng_u64x4((cvprng_t*)p); }
+
+static uint32_t kat_digest(u64x4_t expect, u64x4_t d)
+{
+  if (u64x4_eq(expect, d)) return test_pass();
+  dump2_u64x4(expect, d);
+  return test_fail();
+}
+
+uint32_t check_kat(void)
+{
+  const kat_t* kat = kat_find();
+
+  vprng_t  prng;
+  cvprng_t cprng;
+  uint32_t errors = 0;
+  
+  if (kat == NULL) {
+    printf(WARNING "  no known-answer entry (see: self_check --kat)" ENDC "\n");
+    return 1;
+  }
+
+  kat_fixed_init(&prng, &cprng);
+  test_name("vprng KAT:");
+  errors += kat_vectors(kat->v, kat_next_v, &prng);
+  test_name("cvprng KAT:");
+  errors += kat_vectors(kat->c, kat_next_c, &cprng);
+
+  kat_fixed_init(&prng, &cprng);
+  test_name("vprng 1GiB digest:");
+  errors += kat_digest(kat->vd, vprng_digest(&prng));
+  test_name("cvprng 1GiB digest:");
+  errors += kat_digest(kat->cd, cvprng_digest(&cprng));
+
+  return errors;
+}
+
+static void kat_print_u64x4(u64x4_t v)
+{
+  printf("{0x%016" PRIx64 ",0x%016" PRIx64 ",0x%016" PRIx64 ",0x%016" PRIx64 "}",
+	 v[0],v[1],v[2],v[3]);
+}
+
+// dump the kat.h entry for the current variant
+void kat_generate(void)
+{
+  vprng_t  prng;
+  cvprng_t cprng;
+
+  kat_fixed_init(&prng, &cprng);
+  
+  printf("  {\n    .name = \"%s\",\n", VPRNG_NAME);
+  
+  if (VPRNG_STATE_WORDS != 1)
+    printf("    .words = %u,\n", VPRNG_STATE_WORDS);
+  
+  printf("    .v = {\n");
+  for(uint32_t i=0; i<KAT_LEN; i++) {
+    printf("      "); kat_print_u64x4(vprng_u64x4(&prng)); printf(",\n");
+  }
+  printf("    },\n    .c = {\n");
+  for(uint32_t i=0; i<KAT_LEN; i++) {
+    printf("      "); kat_print_u64x4(cvprng_u64x4(&cprng)); printf(",\n");
+  }
+  printf("    },\n");
+
+  kat_fixed_init(&prng, &cprng);
+  printf("    .vd = "); kat_print_u64x4( vprng_digest(&prng));  printf(",\n");
+  printf("    .cd = "); kat_print_u64x4(cvprng_digest(&cprng)); printf(",\n");
+  printf("  },\n");
+}
+
+
+int main(int argc, char** argv)
+{
+  if (argc > 1) {
+    if (strcmp(argv[1], "--kat") == 0) { kat_generate(); return 0; }
+    printf("usage: %s [--kat]\n", argv[0]);
+    return -1;
+  }
+  
+  uint32_t errors = 0;
+
+  test_banner(VPRNG_NAME);
+  
 #if !defined(VPRNG_INCLUDE)
   vprng_t  prng;
   cvprng_t cprng;
@@ -227,25 +1376,53 @@ int main(void)
   vprng_init(&prng);
   cvprng_init(&cprng);
   
-  uint32_t errors = 0;
-
   errors += check_basic();
   errors += check_inv(&prng);
-  errors += check_pos(&prng);
-
+#elif (VPRNG_VARIANT_ID == 2)
+  errors += check_inv_vpcg32();
+#endif
 
-  if (!errors) {
-    return 0;
+#if !defined(VPRNG_STATE_EXTERNAL) || defined(VPRNG_POS_EXTERNAL)
+  {
+    vprng_t prng;
+    vprng_init(&prng);
+    errors += check_pos(&prng);
+    errors += check_pos_jump(&prng);
+    errors += check_lanes(&prng);
   }
-#else
-  test_banner(VPRNG_NAME);
+#endif
+
+  errors += check_kat();
+  errors += check_hash();
+  errors += check_f2_jump();
+  errors += check_gf2();
+  errors += check_fill();
+  errors += check_perm();
+  errors += check_text();
+  errors += check_uuid();
+#if defined(CHECK_MATRIX)
+  errors += check_matrix();
+#endif
+#if defined(CHECK_POOL)
+  errors += check_pool();
+#endif
+#if !defined(VPRNG_ADDITIVE_CONSTANT_EXTERN)
+  errors += check_init_n();
+  errors += check_init_index();
+  errors += check_thread_ids();
+#if !defined(VPRNG_HIGHLANDER)
+  errors += check_split();
+#endif
+#if defined(CHECK_SHM)
+  errors += check_thread_id_exhausted();
+  errors += check_shm();
+#endif
+#endif
+  errors += check_serialize();
+
 #if defined(SELF_TEST)
-  return (int)self_test();
-#else
-  printf(OKGREEN "  has no specialized tests defined\n" ENDC);
-  return 0;
+  errors += self_test();
 #endif
-#endif  
 
-  return -1;
+  return errors ? -1 : 0;
 }
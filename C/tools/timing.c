@@ -168,6 +168,18 @@ __attribute__((noinline)) void cvprng_fill_f32(cvprng_t* prng)
 
 #endif
 
+#if defined(VPRNG_AES_VAES512)
+vprng_t vprng_x2[2];
+
+// two generators per call: same number of results as the others
+__attribute__((noinline)) void vprng_aes_fill_x2(vprng_t* prng)
+{
+  u32x8_t* d = (u32x8_t*)raw_buffer;
+
+  for(uint32_t i=0; i<BUFFER_LEN; i+=2) { vprng_aes_u32x8_x2(d+i, prng, prng+1); }
+}
+#endif
+
 
 typedef struct {
   char* name;
@@ -188,6 +200,10 @@ func_entry_t func_table[] =
     {.name = "mem cvprng u32", .f=(void*)cvprng_fill_u32, .state=&cvprng},
     {.name = "mem cvprng f32", .f=(void*)cvprng_fill_f32, .state=&cvprng},
 
+#if defined(VPRNG_AES_VAES512)
+    {.name = "mem vprng  u32 x2", .f=(void*)vprng_aes_fill_x2, .state=vprng_x2},
+#endif
+
     // add some off-the-shelf to the build for the "default"
 #if !defined(VPRNG_INCLUDE)
   //{.name = "nop",            .f=(void*)nop,             .state=0},
@@ -349,6 +365,10 @@ int main(void)
 
   vprng_init(&vprng);
   cvprng_init(&cvprng);
+#if defined(VPRNG_AES_VAES512)
+  vprng_init(vprng_x2);
+  vprng_init(vprng_x2+1);
+#endif
 
   if (time_cycles) {
     time_string = time_string_cycles;
@@ -6,10 +6,9 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <inttypes.h>
-#include <m4ri/m4ri_config.h>
-#include <m4ri/m4ri.h>
 
 #include "vprng.h"     // just for some defines
+#include "vprng_gf2.h"
 #include "common.h"
 #include "xorshift.h"
 
@@ -40,67 +39,6 @@
 ( 11, 5, 32)
 #endif
 
-// copy/paste/hack code-----
-
-mzd_t* m4ri_alloc_n(uint32_t n)
-{
-  return mzd_init((rci_t)n,(rci_t)n);
-}
-
-mzd_t* m4ri_alloc_64(void) { return m4ri_alloc_n(64); }
-
-inline mzd_t* mat_mul(mzd_t* r, mzd_t* a, mzd_t* b) { return mzd_mul(r,a,b,0); }
-
-// Does M4RI have this and I'm just not finding it?
-void m4ri_pow(mzd_t* m, uint64_t n)
-{
-  mzd_t* s = mzd_copy(0,m);
-  mzd_t* t = mzd_copy(0,m);
-  
-  mzd_set_ui(m,1);
-
-  while(n != 0) {
-    if (n & 1) {
-      t = mzd_copy(t,m);
-      m = mat_mul(m,t,s);
-    }
-    
-    mat_mul(t,s,s);
-    mzd_copy(s,t);
-    n >>= 1;
-  }
-  
-  mzd_free(t);
-  mzd_free(s);
-}
-
-// convert dense matrix into preallocated M4RI
-void to_m4ri(mzd_t* d, uint64_t s[static 64])
-{
-  const rci_t D = 64;
-  
-  for(rci_t r=0; r<D; r++) {
-    uint64_t row = s[r];
-    for(rci_t c=0; c<D; c++) {
-      mzd_write_bit(d,r,c, row & 1);
-      row >>= 1;
-    }
-  }
-}
-
-// column 'c' of 64x64 matrix
-uint64_t get_col_m4ri(mzd_t* m, uint32_t c)
-{
-  uint64_t r = 0;
-
-  for(uint32_t i=0; i<64; i++)
-    r |= (uint64_t)mzd_read_bit(m,(rci_t)i,(rci_t)c) << i;
-
-  return r;
-}
-
-
-
 // the state update function
 
 #if  0
@@ -146,21 +84,18 @@ uint64_t build_m(uint64_t x)
 
 void build_3_term(void)
 {
-  uint64_t d[64];
-  mzd_t*   m = m4ri_alloc_64();
-  mzd_t*   p = m4ri_alloc_64();
+  vprng_gf2_mat_t m;
+  vprng_gf2_mat_t p;
   uint64_t r = 1;
 
   for(uint32_t i=0; i<LENGTHOF(xorshift_def); i++) {
     def = xorshift_def+i;
 
     // create the matrix (M)
-    func_to_mat(d, build_m);
-    to_m4ri(m,d);
+    func_to_mat(m.r, build_m);
 
     // check that it's invertiable which means it's full rank
-    mzd_copy(p,m);
-    int legal = (mzd_echelonize(p,1) == 64);
+    int legal = (vprng_gf2_rank(&m) == 64);
 
     if (!legal) printf("WAT!"); 
     
@@ -183,12 +118,11 @@ void build_3_term(void)
 
     // compute M^p (p from array offsets)
     for(uint32_t i=0; i<4; i++) {
-      mzd_copy(p,m);
-      m4ri_pow(p,offsets[i]);
+      vprng_gf2_pow(&p,&m,offsets[i]);
 
       // result is the first column since
       // we're transforming '1'.
-      r = get_col_m4ri(p,0);
+      r = vprng_gf2_col(&p,0);
       printf("0x%016" PRIx64 ",", r);
     }
     
@@ -198,13 +132,10 @@ void build_3_term(void)
     printf(" {0x1");
 
     // compute M^i 
-    mzd_copy(p,m);
-
     for(uint32_t i=1; i<5; i++) {
       // dumb. but so what.
-      mzd_copy(p,m);
-      m4ri_pow(p,i);
-      r = get_col_m4ri(p,0);
+      vprng_gf2_pow(&p,&m,i);
+      r = vprng_gf2_col(&p,0);
       printf(",0x%" PRIx64, r);
     }
     
@@ -217,33 +148,33 @@ void build_3_term(void)
 
 void dump_powers(void)
 {
-  uint64_t d[64];
-  mzd_t*   m = m4ri_alloc_64();
-  mzd_t*   p = m4ri_alloc_64();
+  vprng_gf2_mat_t  m;
+  vprng_gf2_mat_t  p;
+  vprng_gf2_jump_t j;
   uint64_t r = 1;
 
   def = xorshift_def;
   
   // create the matrix (M)
-  func_to_mat(d, build_m);
-  to_m4ri(m,d);
+  func_to_mat(m.r, build_m);
 
-  for(uint32_t i=0; i<65; i++) {
-    mzd_copy(p,m);
-    m4ri_pow(p,1ull<<i);
-    
-    // result is the first column since
-    // we're transforming '1'.
-    r = get_col_m4ri(p,0);
+  // table of M^(2^i). the first column of M^(2^i) is
+  // the result of transforming '1'.
+  vprng_gf2_jump_init(&j,&m);
+
+  for(uint32_t i=0; i<64; i++) {
+    r = vprng_gf2_jump(&j,1,UINT64_C(1)<<i);
     printf("0x%016" PRIx64 ", // %2u\n", r,i);
   }
 
-  mzd_copy(p,m);
-  m4ri_pow(p,64-1);
+  // M^(2^64) = M (the period is 2^64-1)
+  printf("0x%016" PRIx64 ", // %2u\n", vprng_gf2_col(&m,0),64);
+
+  vprng_gf2_pow(&p,&m,64-1);
   
   // result is the first column since
   // we're transforming '1'.
-  r = get_col_m4ri(p,0);
+  r = vprng_gf2_col(&p,0);
   printf("---0x%016" PRIx64 ", // \n", r);
 }
 
@@ -13,14 +13,13 @@
 // discarding half the bits produced which should allow
 // a weaker finalizer. This doesn't follow that pattern.
 
-// TODO:
-// * deal with generator pos functions which will be whacked
-
 #pragma once
 
 #define VPRNG_NAME "vpcg"
+#define VPRNG_VARIANT_ID 1
 #define VPRNG_STATE_EXTERNAL
 #define VPRNG_MIX_EXTERNAL
+#define VPRNG_POS_EXTERNAL
 
 #include "vprng.h"
 
@@ -52,9 +51,72 @@ static inline u64x4_t vprng_state_up(u64x4_t s, u64x4_t i)
 // temp hack: see "vsplitmix.h"
 static inline u32x8_t vprng_mix(vprng_unused vprng_t* prng, u64x4_t x)
 {
-  x ^= x >> 30; x *= UINT64_C(0x4be98134a5976fd3);
-  x ^= x >> 29; x *= UINT64_C(0x3bc0993a5ad19a13);
-  x ^= x >> 31;
+  return vprng_cast_u32(vprng_mix14(x));
+}
+
+static inline u64x4_t vprng_unmix(vprng_unused vprng_t* prng, u32x8_t x)
+{
+  return vprng_mix14_inv(vprng_cast_u64(x));
+}
+
+
+//****************************************************************************
+// position in stream. LCG jumps are Brown's method: "Random Number
+// Generation with Arbitrary Strides" (all lanes at once). Distance
+// is the matching bit-by-bit method (requires m = 1 mod 4 & odd
+// additive constants which is true for all lanes)
+
+#if defined(VPRNG_IMPLEMENTATION)
+
+// moves position in stream of each lane by 'off'. The per lane
+// bits select the multiplier: m (bit set) or 1.
+void vprng_pos_inc_v(vprng_t* prng, u64x4_t off)
+{
+  u64x4_t m  = vpcg_mul_k;
+  u64x4_t a  = vprng_inc(prng);
+  u64x4_t am = vprng_splat_u64(1);
+  u64x4_t aa = {0};
+
+  while ((off[0]|off[1]|off[2]|off[3]) != 0) {
+    u64x4_t k  = -(off & 1);
+    u64x4_t mk = (m & k) | (~k & 1);
+    am  *= mk;
+    aa   = aa*mk + (a & k);
+    a   *= m+1;
+    m   *= m;
+    off >>= 1;
+  }
 
-  return vprng_cast_u32(x);
+  prng->state = am*prng->state + aa;
 }
+
+// per lane number of steps from 's' to 't'
+static u64x4_t vpcg_distance(u64x4_t s, u64x4_t t, u64x4_t a)
+{
+  u64x4_t m = vpcg_mul_k;
+  u64x4_t d = {0};
+
+  for(uint32_t i=0; i<64; i++) {
+    u64x4_t b = vprng_splat_u64(UINT64_C(1) << i);
+    u64x4_t k = -(((s^t) >> i) & 1);
+
+    s  = (s & ~k) | ((m*s+a) & k);
+    d |= b & k;
+    a *= m+1;
+    m *= m;
+  }
+
+  return d;
+}
+
+// position in stream of each lane
+u64x4_t vprng_pos_get_v(vprng_t* prng)
+{
+  vprng_t t = *prng;
+
+  vprng_pos_init(&t);
+
+  return vpcg_distance(t.state, prng->state, vprng_inc(prng));
+}
+
+#endif
@@ -45,9 +45,11 @@ length= 8 gigabytes (2^33 bytes), time= 173 seconds
 #pragma once
 
 #define VPRNG_NAME "vpcg32"
+#define VPRNG_VARIANT_ID 2
 #define VPRNG_ADDITIVE_CONSTANT_EXTERN
 #define VPRNG_STATE_EXTERNAL
 #define VPRNG_MIX_EXTERNAL
+#define VPRNG_POS_EXTERNAL
 //#define VPRNG_CMIX_EXTERNAL  // should be disabled ATM (just for spot checking)
 
 #include "vprng.h"
@@ -91,6 +93,21 @@ static inline u32x8_t vprng_mix(vprng_unused vprng_t* prng, u64x4_t x)
   return u;
 }
 
+// inverse of vprng_mix: mod inverses of vpcg_mul_{m0,m1} and the
+// xorshift inverses (a right xorshift by 's' repeated at multiples
+// of 's' while less than 32)
+static const u32x8_t vpcg_mul_i0 = {0x333c4925,0xa46b8a05,0x1d69e2a5,0x7749bd2d,0x298933c3,0x9758f463,0x37074925,0x53868f1d};
+static const u32x8_t vpcg_mul_i1 = {0x97132227,0x833434f9,0x43021123,0x9ac71bd9,0xe129eed9,0x9edf787b,0x7cbfd2f5,0xcb47a523};
+
+static inline u64x4_t vprng_unmix(vprng_unused vprng_t* prng, u32x8_t u)
+{
+  u ^= u >> 15; u ^= u >> 30; u *= vpcg_mul_i1;
+  u ^= u >> 15; u ^= u >> 30; u *= vpcg_mul_i0;
+  u ^= u >> 16;
+
+  return vprng_cast_u64(u);
+}
+
 #if defined(VPRNG_CMIX_EXTERNAL)
 
 // add a real mixer for combine that operates on 64-bit chucks.
@@ -175,9 +192,73 @@ void vprng_init(vprng_t* prng)
   prng->inc = vprng_cast_u64(v);
 #endif  
 
+  vprng_init_extra(prng);
   vprng_pos_init(prng);
 }
 
+// position in stream: same as 'vpcg.h' except eight 32-bit LCGs.
+// periods are 2^32 so positions are modulo that.
+
+// moves position in stream of each lane by 'off' (both 32-bit
+// LCGs of a lane by the same amount)
+void vprng_pos_inc_v(vprng_t* prng, u64x4_t off)
+{
+  u32x8_t m  = vpcg_mul_k;
+  u32x8_t a  = vprng_cast_u32(vprng_inc(prng));
+  u32x8_t am = vprng_splat_u32(1);
+  u32x8_t aa = {0};
+  u32x8_t o  = vprng_cast_u32((off & 0xffffffff) | (off << 32));
+
+  off = vprng_cast_u64(o);
+
+  while ((off[0]|off[1]|off[2]|off[3]) != 0) {
+    u32x8_t k  = -(o & 1);
+    u32x8_t mk = (m & k) | (~k & 1);
+    am  *= mk;
+    aa   = aa*mk + (a & k);
+    a   *= m+1;
+    m   *= m;
+    o  >>= 1;
+    off = vprng_cast_u64(o);
+  }
+
+  prng->state = vprng_cast_u64(am*vprng_cast_u32(prng->state) + aa);
+}
+
+// per lane number of steps from 's' to 't'
+static u32x8_t vpcg_distance(u32x8_t s, u32x8_t t, u32x8_t a)
+{
+  u32x8_t m = vpcg_mul_k;
+  u32x8_t d = {0};
+
+  for(uint32_t i=0; i<32; i++) {
+    u32x8_t b = vprng_splat_u32(UINT32_C(1) << i);
+    u32x8_t k = -(((s^t) >> i) & 1);
+
+    s  = (s & ~k) | ((m*s+a) & k);
+    d |= b & k;
+    a *= m+1;
+    m *= m;
+  }
+
+  return d;
+}
+
+// position in stream of each lane (of the low 32-bit LCG of the
+// lane. both are at the same position unless modified directly)
+u64x4_t vprng_pos_get_v(vprng_t* prng)
+{
+  vprng_t t = *prng;
+
+  vprng_pos_init(&t);
+
+  u32x8_t d = vpcg_distance(vprng_cast_u32(t.state),
+			    vprng_cast_u32(prng->state),
+			    vprng_cast_u32(vprng_inc(prng)));
+  
+  return vprng_cast_u64(d) & 0xffffffff;
+}
+
 #else
 
 // fill-in
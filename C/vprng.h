@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include <math.h>
 #include <string.h>
+#include <stdlib.h>
 #include <assert.h>
 
 /*
@@ -109,6 +110,10 @@
   A compile time option (VPRNG_CVPRNG_3TERM) changes the state
   update to a standard 3-term XorShift.
 
+  VPRNG_STATE_WORDS (2 or 4) replaces the single word XorShift
+  with the linear engine of xoroshiro128 or xoshiro256 (periods
+  2^128-1 and 2^256-1) at the cost of a few more ops.
+
   ──────────────────────────────────────────────────────────────
   Bit finalizing (mixing stage)
 
@@ -185,6 +190,13 @@
 #define VPRNG_NAME "vprng"
 #endif
 
+// small integer tag for the variant. used by serialization to reject
+// data from a different variant. (vprng=0, vpcg=1, vpcg32=2,
+// vsplitmix=3, vprng_aes=4)
+#ifndef VPRNG_VARIANT_ID
+#define VPRNG_VARIANT_ID 0
+#endif
+
 // this should detect if we have a SIMD hardware op for
 // converting an 64-bit integer into a double. The wrapper
 // allows overriding the detection.
@@ -252,6 +264,15 @@ static inline u64x4_t vprng_splat_u64(uint64_t x)
 // remaining function defs later in file
 #endif
 
+// SWAR population count of each lane
+static inline u64x4_t vprng_pop_u64x4(u64x4_t x)
+{
+  x = x - ((x >> 1) & UINT64_C(0x5555555555555555));
+  x = (x & UINT64_C(0x3333333333333333)) + ((x >> 2) & UINT64_C(0x3333333333333333));
+  x = (x + (x >> 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+  return (x * UINT64_C(0x0101010101010101)) >> 56;
+}
+
 
 //*******************************************************************
 // pay no attention to the man behind the curtain
@@ -275,19 +296,66 @@ static inline u64x4_t vprng_splat_u64(uint64_t x)
 //*******************************************************************
 // core of the PRNGs defined here
 
+// a variant can add per-generator data (VPRNG_STATE_EXTRA, a list
+// of member declarations) which is computed from the additive
+// constants by 'vprng_init_extra' (VPRNG_INIT_EXTRA) on init.
+#if !defined(VPRNG_STATE_EXTRA)
+#define VPRNG_STATE_EXTRA
+#endif
+
 #if !defined(VPRNG_HIGHLANDER)
-typedef struct { u64x4_t state; u64x4_t inc;  } vprng_t;
+typedef struct { u64x4_t state; u64x4_t inc; VPRNG_STATE_EXTRA } vprng_t;
 #else
-typedef struct { u64x4_t state; } vprng_t;
+typedef struct { u64x4_t state; VPRNG_STATE_EXTRA } vprng_t;
 #endif
 
-// allow more than single word F2 generators
-#if !defined(VPRNG_SOMETHING_OR_OTHER)
+#if defined(VPRNG_INIT_EXTRA)
+static inline void vprng_init_extra(vprng_t* prng);
+#else
+static inline void vprng_init_extra(vprng_unused vprng_t* prng) {}
+#endif
+
+// number of 64-bit words (per lane) of the F2 second state of the
+// combined generator: 1 (default: xorshift), 2 (xoroshiro128) or
+// 4 (xoshiro256). Period of the combined is 2^64(2^(64w)-1)
+#if !defined(VPRNG_STATE_WORDS)
 #define VPRNG_STATE_WORDS 1
 #endif
 
+#if (VPRNG_STATE_WORDS != 1) && (VPRNG_STATE_WORDS != 2) && (VPRNG_STATE_WORDS != 4)
+#error "VPRNG_STATE_WORDS must be 1, 2 or 4"
+#endif
+
 typedef struct { vprng_t base;  u64x4_t f2[VPRNG_STATE_WORDS]; } cvprng_t;
 
+// size of the serialized form of vprng_t/cvprng_t (see vprng_serialize)
+#define VPRNG_SERIAL_BYTES 24
+
+// rank/select index over the accepted ids of the additive constant
+// generation (see vprng_additive_next) so the k^th generator can be
+// initialized directly (vprng_init_index) instead of walking all
+// previous ids. Generator 'k' is the k^th vprng_init (single thread)
+// after the global id is set to 'base'.
+//   count[i] = number of accepted ids in [base, base+i*VPRNG_INDEX_BLOCK)
+// covers up to 2^30 generators. 'count' is caller provided with
+// vprng_index_entries(n) elements (~4 bytes per 124 generators).
+// A lookup is the block estimate and a SIMD scan of the block
+// (~2.4K cycles)
+#define VPRNG_INDEX_BLOCK 512
+
+typedef struct {
+  uint64_t  base;
+  uint64_t  n;
+  uint32_t  blocks;
+  uint32_t* count;
+} vprng_index_t;
+
+// acceptance rate is ~97% (pad to 1/16)
+static inline size_t vprng_index_entries(uint64_t n)
+{
+  return (size_t)((4*n + ((4*n) >> 4))/VPRNG_INDEX_BLOCK + 2);
+}
+
 
 // 32x8 integer product
 static inline u64x4_t vprng_mix_mul(u64x4_t x, u32x8_t m)
@@ -295,9 +363,6 @@ static inline u64x4_t vprng_mix_mul(u64x4_t x, u32x8_t m)
   return vprng_cast_u64(vprng_cast_u32(x)*m);
 }
 
-// compile time select the bit finalizer
-#if !defined(VPRNG_MIX_EXTERNAL)
-
 // newer version than initial check-in. hand refined
 // constants and added an extra xorshift. This
 // drastically improved SAC measures. An optimizing
@@ -347,17 +412,96 @@ static const u32x8_t vprng_finalize_m1 =
   0b01011010010101001001110100010111,
 };
 
-static inline u32x8_t vprng_mix(vprng_unused vprng_t* prng, u64x4_t x)
+// the default bit finalizer with multiplicative constants (m0,m1)
+static inline u64x4_t vprng_finalize_k(u64x4_t x, u32x8_t m0, u32x8_t m1)
 {
   x ^= x >> 33;
   
-  x ^= x >> 16; x = vprng_mix_mul(x,vprng_finalize_m0);
-  x ^= x << 16; x = vprng_mix_mul(x,vprng_finalize_m1);
-  x ^= x >> 16; x = vprng_mix_mul(x,vprng_finalize_m0);
+  x ^= x >> 16; x = vprng_mix_mul(x,m0);
+  x ^= x << 16; x = vprng_mix_mul(x,m1);
+  x ^= x >> 16; x = vprng_mix_mul(x,m0);
 
   x ^= x >> 32;
   
-  return vprng_cast_u32(x);
+  return x;
+}
+
+// bijection: each 64-bit lane has its own constants. (always
+// available for use as a hash regardless of variant)
+static inline u64x4_t vprng_finalize(u64x4_t x)
+{
+  return vprng_finalize_k(x, vprng_finalize_m0, vprng_finalize_m1);
+}
+
+// MIX14: http://zimbry.blogspot.com/2011/09/better-bit-mixing-improving-on.html
+// the SplitMix64 finalizer (used by vsplitmix & vpcg)
+static inline u64x4_t vprng_mix14(u64x4_t x)
+{
+  x ^= x >> 30; x *= UINT64_C(0x4be98134a5976fd3);
+  x ^= x >> 29; x *= UINT64_C(0x3bc0993a5ad19a13);
+  x ^= x >> 31;
+
+  return x;
+}
+
+// inverses: mod inverses of the multiplicative constants are
+// precomputed (check_inv validates) and each 'x ^= x >> s' is
+// inverted by the fixed cascade: x ^= x >> s, x ^= x >> 2s, ...
+// (while less than 64). So the inverse costs one or two extra
+// shift/xor per xorshift.
+
+static const u32x8_t vprng_finalize_i0 =
+{
+  UINT32_C(0xf982eaa9), UINT32_C(0x7794479d), UINT32_C(0xa1ab0903), UINT32_C(0xa922fc9d),
+  UINT32_C(0x17132227), UINT32_C(0x7c42cd83), UINT32_C(0xa2e3c725), UINT32_C(0x2fcf32b7),
+};
+
+static const u32x8_t vprng_finalize_i1 =
+{
+  UINT32_C(0x372e1a75), UINT32_C(0x2a988ea5), UINT32_C(0x2e3cc725), UINT32_C(0x2fcf32b7),
+  UINT32_C(0xe8844925), UINT32_C(0x92aab063), UINT32_C(0xd3894125), UINT32_C(0xb18e6aa7),
+};
+
+// inverse of vprng_finalize_k given the inverse constants (i0,i1)
+static inline u64x4_t vprng_finalize_inv_k(u64x4_t x, u32x8_t i0, u32x8_t i1)
+{
+  x ^= x >> 32;
+
+  x  = vprng_mix_mul(x,i0); x ^= x >> 16; x ^= x >> 32;
+  x  = vprng_mix_mul(x,i1); x ^= x << 16; x ^= x << 32;
+  x  = vprng_mix_mul(x,i0); x ^= x >> 16; x ^= x >> 32;
+
+  x ^= x >> 33;
+
+  return x;
+}
+
+static inline u64x4_t vprng_finalize_inv(u64x4_t x)
+{
+  return vprng_finalize_inv_k(x, vprng_finalize_i0, vprng_finalize_i1);
+}
+
+static inline u64x4_t vprng_mix14_inv(u64x4_t x)
+{
+  x ^= x >> 31; x ^= x >> 62; x *= UINT64_C(0xab56d1249120401b);
+  x ^= x >> 29; x ^= x >> 58; x *= UINT64_C(0x4ab3236cb05fc05b);
+  x ^= x >> 30; x ^= x >> 60;
+
+  return x;
+}
+
+// compile time select the bit finalizer. variants with a bijective
+// finalizer should also supply vprng_unmix (its inverse). All but
+// vprng_aes do (keyed AES rounds: invertible but none is provided)
+#if !defined(VPRNG_MIX_EXTERNAL)
+static inline u32x8_t vprng_mix(vprng_unused vprng_t* prng, u64x4_t x)
+{
+  return vprng_cast_u32(vprng_finalize(x));
+}
+
+static inline u64x4_t vprng_unmix(vprng_unused vprng_t* prng, u32x8_t x)
+{
+  return vprng_finalize_inv(vprng_cast_u64(x));
 }
 #else
 static inline u32x8_t vprng_mix(vprng_t* prng, u64x4_t x);
@@ -383,6 +527,7 @@ static inline u64x4_t vprng_state_up(u64x4_t s, u64x4_t i)
 static inline u64x4_t vprng_state_up(u64x4_t s, u64x4_t i);
 #endif
 
+#if (VPRNG_STATE_WORDS == 1)
 #if !defined(VPRNG_STATE2_EXTERNAL)
 
 // compile time select the second state update
@@ -459,6 +604,92 @@ static inline u64x4_t cvprng_state_up(u64x4_t s)
 static inline u64x4_t cvprng_state_up(u64x4_t s);
 #endif
 
+static inline void cvprng_state_up_w(u64x4_t s[static 1]) { s[0] = cvprng_state_up(s[0]); }
+static inline void cvprng_f2_init(u64x4_t s[static 1])    { s[0] = cvprng_init_k; }
+
+#else
+
+// multiple word second state. Both are the linear engines (no
+// output scrambler) of Blackman & Vigna. The first word is
+// the output.
+//
+// * cvprng_init_kw: initial state. same as the single word with
+//   x_0 = {1,0,...} and lane i at position i*2^(64w-2) + off + {0,31,257,541}[i]
+
+#if defined(VPRNG_STATE2_EXTERNAL)
+#error "VPRNG_STATE2_EXTERNAL is only supported for VPRNG_STATE_WORDS=1"
+#endif
+
+static inline u64x4_t vprng_rotl(u64x4_t x, uint32_t r) { return (x << r) | (x >> (64-r)); }
+
+#if (VPRNG_STATE_WORDS == 2)
+
+static const u64x4_t cvprng_init_kw[2] =
+{
+  {
+    UINT64_C(0xf5dd55f2f4591108), UINT64_C(0x8b1c08438c4d6917),
+    UINT64_C(0x5311bd18e88cd422), UINT64_C(0xa96f17ab572ba3bc)
+  },
+  {
+    UINT64_C(0x2aab54b00ba0ccf5), UINT64_C(0xbe8c0d4d1cadbfa8),
+    UINT64_C(0x16bd3c314bb77b36), UINT64_C(0x25acf0d016e0eeae)
+  }
+};
+
+// xoroshiro128 (24,16,37)
+static inline void cvprng_state_up_w(u64x4_t s[static 2])
+{
+  u64x4_t s0 = s[0];
+  u64x4_t s1 = s[1] ^ s0;
+
+  s[0] = vprng_rotl(s0,24) ^ s1 ^ (s1 << 16);
+  s[1] = vprng_rotl(s1,37);
+}
+
+#else
+
+static const u64x4_t cvprng_init_kw[4] =
+{
+  {
+    UINT64_C(0x4d154b1d3fa919dc), UINT64_C(0x6d952faae168d212),
+    UINT64_C(0xf62548c162707e0f), UINT64_C(0x15e52585eadba448)
+  },
+  {
+    UINT64_C(0x4971479233112d44), UINT64_C(0x188d0b7318876e80),
+    UINT64_C(0xc9a8e766410d1aca), UINT64_C(0x0a562911ac3b56ef)
+  },
+  {
+    UINT64_C(0xede9ab317df61f1d), UINT64_C(0x2cee39ffadff3492),
+    UINT64_C(0x520450a60dfb3bee), UINT64_C(0x33a5470d6a9efcc5)
+  },
+  {
+    UINT64_C(0xa2c1062b9a4f96d6), UINT64_C(0xa1265c2e626e0c30),
+    UINT64_C(0x1d83d93010761e2a), UINT64_C(0x40818e010eadd7fb)
+  }
+};
+
+// xoshiro256
+static inline void cvprng_state_up_w(u64x4_t s[static 4])
+{
+  u64x4_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3]  = vprng_rotl(s[3],45);
+}
+
+#endif
+
+static inline void cvprng_f2_init(u64x4_t s[static VPRNG_STATE_WORDS])
+{
+  memcpy(s, cvprng_init_kw, sizeof(cvprng_init_kw));
+}
+
+#endif
+
 // 
 #if !defined(VPRNG_HIGHLANDER)
 static inline u64x4_t vprng_inc (vprng_t*  prng) { return prng->inc; }
@@ -500,7 +731,7 @@ static inline u32x8_t cvprng_u32x8(cvprng_t* prng)
   vprng_result_barrier(r,s1);
 
   prng->base.state = vprng_state_up (s0, cvprng_inc(prng));
-  prng->f2[0]      = cvprng_state_up(s1);
+  cvprng_state_up_w(prng->f2);
   
   return r;
 }
@@ -548,22 +779,143 @@ static const uint64_t vprng_internal_inc_i  = UINT64_C(0xf1de83e19937733d);
 
 static _Atomic uint64_t vprng_internal_inc_id = 1;
 
-void     vprng_global_id_set(uint64_t id) { atomic_store(&vprng_internal_inc_id, id);   }
-uint64_t vprng_global_id_get(void)        { return atomic_load(&vprng_internal_inc_id); }
+// the global id counter in use: the process local above or one bound
+// by vprng_global_id_bind (such as a shared memory one: vprng_shm.h)
+static _Atomic uint64_t* vprng_internal_id = &vprng_internal_inc_id;
+
+// ignored while a counter is bound: it's shared with other processes
+// and resetting it would hand out ids which are already in use.
+void vprng_global_id_set(uint64_t id)
+{
+  if (vprng_internal_id == &vprng_internal_inc_id)
+    atomic_store(vprng_internal_id, id);
+}
+
+uint64_t vprng_global_id_get(void) { return atomic_load(vprng_internal_id); }
+
+// uses 'counter' as the global id counter (NULL for the process
+// local). Not thread safe: bind before creating generators. While
+// bound vprng_global_id_set has no effect.
+void vprng_global_id_bind(_Atomic uint64_t* counter)
+{
+  vprng_internal_id = counter ? counter : &vprng_internal_inc_id;
+}
+
+// per thread id source. default is the global counter (mode 0)
+// otherwise ids are taken from [next,end) which is either:
+// * mode 1: a lease of 2^bits ids from the global counter which is
+//   renewed when exhausted. one atomic per 2^bits ids.
+// * mode 2: a fixed range (vprng_thread_id_range). no atomics and
+//   the ids of the thread's generators are independent of other
+//   threads (reproducible). running out aborts.
+typedef struct {
+  uint64_t next, end;
+  uint32_t mode, bits;
+} vprng_thread_ids_t;
+
+static _Thread_local vprng_thread_ids_t vprng_thread_ids = {0};
+
+// reserves up to 'c' ids: returns the first and the number
+// actually reserved in 'n' (always 'c' for the global counter)
+static inline uint64_t vprng_id_reserve(uint64_t c, uint64_t* n)
+{
+  vprng_thread_ids_t* t = &vprng_thread_ids;
+
+  if (t->mode == 0) {
+    *n = c;
+    return atomic_fetch_add_explicit(vprng_internal_id, c, memory_order_relaxed);
+  }
+
+  if (t->next == t->end) {
+    // fixed range exhausted: fatal in all builds. taking more ids
+    // from the global counter would silently break reproducibility
+    if (t->mode != 1) {
+      assert(!"vprng: thread id range exhausted");
+      abort();
+    }
+    t->next = atomic_fetch_add_explicit(vprng_internal_id,
+					UINT64_C(1) << t->bits,
+					memory_order_relaxed);
+    t->end  = t->next + (UINT64_C(1) << t->bits);
+  }
+
+  uint64_t id = t->next;
+  uint64_t r  = t->end - id;
+
+  r = (r < c) ? r : c;
+  t->next += r;
+  *n = r;
+
+  return id;
+}
+
+// returns the unused tail [u,e) of the last reservation. for the
+// global counter this fails if another thread has reserved since.
+static inline void vprng_id_unreserve(uint64_t u, uint64_t e)
+{
+  vprng_thread_ids_t* t = &vprng_thread_ids;
+
+  if (t->mode == 0)
+    atomic_compare_exchange_strong_explicit(vprng_internal_id, &e, u,
+					    memory_order_relaxed,
+					    memory_order_relaxed);
+  else if (t->next == e)
+    t->next = u;
+}
+
+// back to the global counter. unused ids of a lease are returned
+// if no other thread has reserved since.
+void vprng_thread_id_release(void)
+{
+  vprng_thread_ids_t* t = &vprng_thread_ids;
+  
+  if (t->mode == 1 && t->next != t->end) {
+    uint64_t e = t->end;
+    atomic_compare_exchange_strong_explicit(vprng_internal_id, &e, t->next,
+					    memory_order_relaxed,
+					    memory_order_relaxed);
+  }
+  
+  memset(t, 0, sizeof(vprng_thread_ids_t));
+}
+
+// the calling thread hands out ids from leases of 2^bits ids
+// taken from the global counter (bits=0 returns to the default)
+void vprng_thread_id_lease(uint32_t bits)
+{
+  vprng_thread_id_release();
+  
+  if (bits != 0) {
+    assert(bits < 64);
+    vprng_thread_ids.mode = 1;
+    vprng_thread_ids.bits = bits;
+  }
+}
+
+// the calling thread hands out ids [id,id+n). For example thread 't'
+// using [1+t*2^k, 1+(t+1)*2^k) gives the same generators every run
+// no matter the scheduling. Running out of ids aborts (also with
+// NDEBUG): leave headroom for ids rejected by the filter.
+void vprng_thread_id_range(uint64_t id, uint64_t n)
+{
+  vprng_thread_id_release();
+
+  vprng_thread_ids.mode = 2;
+  vprng_thread_ids.next = id;
+  vprng_thread_ids.end  = id+n;
+}
 
 //#warning "testing vprng_addtive_next hack in progress"
 
 // returns an additive constant for the state update
 static uint64_t vprng_additive_next(void)
 {
-  uint64_t b;
+  uint64_t b,n;
 
   do {
-    // atomically increment the global counter and
+    // increment the counter (global or thread) and
     // convert it into a candidate additive constant
-    b  = atomic_fetch_add_explicit(&vprng_internal_inc_id,
-				   1,
-				   memory_order_relaxed);
+    b  = vprng_id_reserve(1,&n);
     b  = (b<<1)|1;
     b *= vprng_internal_inc_k;
 
@@ -580,6 +932,157 @@ static uint64_t vprng_additive_next(void)
     }
   } while(1);
 }
+
+// vprng_additive_next for four consecutive ids (id+{0,1,2,3}) at
+// once: returns the candidate constants in 'b' and lane 'i' is
+// accepted if bit 'i' of the result is set
+static inline uint32_t vprng_additive_filter(u64x4_t* b, uint64_t id)
+{
+  static const u64x4_t lane = {0,1,2,3};
+
+  u64x4_t c   = ((vprng_splat_u64(id) + lane) << 1) | 1;
+  u64x4_t pop, str, ok;
+  uint32_t r  = 0;
+
+  c  *= vprng_internal_inc_k;
+  pop = vprng_pop_u64x4(c);
+  str = vprng_pop_u64x4(c & (c ^ (c >> 1)));
+  ok  = ((pop - (32-8)) <= 2*8) & (str >= (pop >> 2));
+
+  for(uint32_t i=0; i<4; i++) r |= (uint32_t)(ok[i] & 1) << i;
+
+  *b = c;
+
+  return r;
+}
+
+// additive constant of the first accepted id >= 'id' (no counter)
+static uint64_t vprng_additive_at(uint64_t id)
+{
+  do {
+    u64x4_t  b;
+    uint32_t m = vprng_additive_filter(&b, id);
+
+    if (m != 0) return b[__builtin_ctz(m)];
+
+    id += 4;
+  } while(1);
+}
+
+// fills the additive constants of 'n' generators spaced by 'stride'
+// bytes. Same result as 'n' calls of vprng_additive_next per lane
+// (if no other thread is taking ids) but the ids are reserved at
+// once (a single atomic add for the global counter in the expected
+// case) and filtered four at a time. Any unused tail of the
+// reservation is returned.
+static void vprng_additive_next_n(vprng_t* prng, size_t n, size_t stride)
+{
+  uint64_t need = 4*(uint64_t)n;
+  uint64_t k    = 0;
+
+  while (k < need) {
+    // acceptance rate is ~97%. reserve with a little headroom
+    uint64_t c  = need-k;
+    uint64_t id, e, u;
+
+    c  = (c + (c >> 4) + 8) & ~UINT64_C(3);
+    id = vprng_id_reserve(c, &c);
+    e  = id + c;
+    u  = e;
+
+    for(; id < e; id += 4) {
+      u64x4_t  b;
+      uint32_t m = vprng_additive_filter(&b, id);
+
+      // partial group at the end of a thread range
+      if (e-id < 4) m &= (1u << (e-id))-1;
+
+      while (m != 0) {
+	uint32_t j = (uint32_t)__builtin_ctz(m);
+	vprng_t* p = (vprng_t*)((char*)prng + (k >> 2)*stride);
+
+	p->inc[k & 3] = b[j];
+	m &= m-1;
+
+	if (++k == need) { u = id+j+1; break; }
+      }
+      if (k == need) break;
+    }
+
+    // give back the unused ids
+    if (u != e) vprng_id_unreserve(u,e);
+  }
+}
+
+// builds the index for generators [0,n) starting at id 'base'.
+// 'count' must have vprng_index_entries(n) elements
+void vprng_index_init(vprng_index_t* index, uint32_t* count, uint64_t n, uint64_t base)
+{
+  uint64_t need = 4*n;
+  uint64_t t    = 0;
+  uint32_t b    = 0;
+  
+  assert(need <= UINT32_MAX);
+  
+  index->base  = base;
+  index->n     = n;
+  index->count = count;
+
+  count[0] = 0;
+
+  while (t < need) {
+    uint64_t id = base + (uint64_t)b*VPRNG_INDEX_BLOCK;
+
+    for(uint32_t i=0; i<VPRNG_INDEX_BLOCK; i+=4) {
+      u64x4_t c;
+      t += vprng_pop(vprng_additive_filter(&c, id+i));
+    }
+    
+    count[++b] = (uint32_t)t;
+    
+    assert(b < vprng_index_entries(n));
+  }
+
+  index->blocks = b;
+}
+
+// fills the additive constants with accepted ids starting at
+// rank 'r' (within the index)
+static void vprng_index_select(vprng_t* prng, const vprng_index_t* index, uint64_t r)
+{
+  const uint32_t* count = index->count;
+
+  // estimate the block (2^32/(0.967*4096) scaled) and correct
+  uint32_t b = (uint32_t)((r*(UINT64_C(0x108ae8)*4096/VPRNG_INDEX_BLOCK))>>32);
+
+  if (b >= index->blocks) b = index->blocks-1;
+  
+  while (count[b]   >  r) b--;
+  while (count[b+1] <= r) b++;
+
+  // in block: four at a time
+  uint64_t id = index->base + (uint64_t)b*VPRNG_INDEX_BLOCK;
+  uint32_t k  = (uint32_t)(r - count[b]);
+  uint32_t j  = 0;
+
+  do {
+    u64x4_t  c;
+    uint32_t m = vprng_additive_filter(&c, id);
+    uint32_t p = vprng_pop(m);
+
+    if (k >= p) { k -= p; id += 4; continue; }
+
+    // skip the remaining 'k' of this group and take the rest
+    while (k) { m &= m-1; k--; }
+
+    while (m != 0 && j < 4) {
+      prng->inc[j++] = c[__builtin_ctz(m)];
+      m &= m-1;
+    }
+    id += 4;
+  } while (j < 4);
+}
+
 #endif
 
 //*******************************************************************
@@ -605,100 +1108,724 @@ void vprng_init(vprng_t* prng)
   prng->inc[3]  = vprng_additive_next();
 #endif  
 
+  vprng_init_extra(prng);
   vprng_pos_init(prng);
 }
 
-#else
-extern void vprng_init(vprng_t* prng);
-#endif
+// initializes 'n' generators: same as 'n' calls to vprng_init but
+// the ids are reserved at once (one atomic in the expected case)
+void vprng_init_n(vprng_t* prng, size_t n)
+{
+#if !defined(VPRNG_HIGHLANDER)  
+  vprng_additive_next_n(prng, n, sizeof(vprng_t));
+#endif  
 
+  for(size_t i=0; i<n; i++) {
+    vprng_init_extra(prng+i);
+    vprng_pos_init(prng+i);
+  }
+}
 
-void cvprng_init(cvprng_t* prng)
+void cvprng_init_n(cvprng_t* prng, size_t n)
 {
-  vprng_init(&(prng->base));
-  prng->f2[0] = cvprng_init_k;  
-}
+#if !defined(VPRNG_HIGHLANDER)  
+  vprng_additive_next_n(&prng->base, n, sizeof(cvprng_t));
+#endif  
 
+  for(size_t i=0; i<n; i++) {
+    vprng_init_extra(&prng[i].base);
+    vprng_pos_init(&prng[i].base);
+    cvprng_f2_init(prng[i].f2);
+  }
+}
 
-// mod-inverse of 64-bit integer
-static uint64_t vprng_modinv(uint64_t a)
+// initializes 'prng' as generator 'k' of 'index'
+void vprng_init_index(vprng_t* prng, const vprng_index_t* index, uint64_t k)
 {
-  uint64_t x = (3*a)^2; 
-  uint64_t y  = 1 - a*x;
-  x = x*(1+y); y *= y;
-  x = x*(1+y); y *= y;
-  x = x*(1+y); y *= y;
-  x = x*(1+y);
+  assert(k < index->n);
+  
+#if !defined(VPRNG_HIGHLANDER)  
+  vprng_index_select(prng, index, 4*k);
+#endif
+  
+  vprng_init_extra(prng);
+  vprng_pos_init(prng);
+}
 
-  return x;
+void cvprng_init_index(cvprng_t* prng, const vprng_index_t* index, uint64_t k)
+{
+  vprng_init_index(&prng->base, index, k);
+  cvprng_f2_init(prng->f2);
 }
 
-#if !(defined(VPRNG_HIGHLANDER)||defined(VPRNG_ADDITIVE_CONSTANT_EXTERN))
+#if !defined(VPRNG_HIGHLANDER)
 
-uint64_t vprng_id_get(vprng_t* prng)
+// Counter free derivation of generators. Four 64-bit hashes 'h'
+// become the ids (h>>1) of the new generator's lanes (moved up to
+// the next accepted id) at position zero. Derived ids are spread
+// over 2^63 so collisions with each other (and the small ids of
+// the global counter) are birthday bound unlikely. 
+static void vprng_init_hash(vprng_t* prng, u64x4_t h)
 {
-  // multiply by mod-inverse and nuke the "to odd" transform
-  return (vprng_internal_inc_i*prng->inc[0])>>1;
+  for(uint32_t i=0; i<4; i++)
+    prng->inc[i] = vprng_additive_at(h[i] >> 1);
+
+  vprng_init_extra(prng);
+  vprng_pos_init(prng);
 }
 
-uint64_t cvprng_id_get(cvprng_t* prng)
+// SplitMix style: 'child' is created from the next output of
+// 'parent' (which is advanced). Reproducible given the parent
+// and the sequence of splits.
+void vprng_split(vprng_t* parent, vprng_t* child)
 {
-  return vprng_id_get(&prng->base);
+  vprng_init_hash(child, vprng_cast_u64(vprng_u32x8(parent)));
 }
 
-// get the current position in the stream
-uint64_t vprng_pos_get(vprng_t* prng)
+// the generator for the key 'path' (depth keys) below 'root' (its
+// id & position, not modified): at each level 'key' times the
+// additive constant is added to the current generator's state (for
+// a Weyl state: 'key' steps ahead) and pushed twice through its
+// mixer. Independent of scheduling and order of derivation.
+// (depth=0 is 'root')
+void vprng_derive(vprng_t* prng, const vprng_t* root, const uint64_t path[], uint32_t depth)
 {
-  return prng->state[0] * vprng_modinv(prng->inc[0]) - 1;
-}
+  vprng_t t = *root;
+  
+  for(uint32_t d=0; d<depth; d++) {
+    u64x4_t s = t.state + vprng_splat_u64(path[d])*t.inc;
+    u64x4_t h = vprng_cast_u64(vprng_mix(&t, s));
 
-#else
+    h = vprng_cast_u64(vprng_mix(&t, h ^ t.inc));
+    
+    vprng_init_hash(&t, h);
+  }
 
-uint64_t vprng_id_get (vprng_unused vprng_t*   prng) { return 0; }
-uint64_t cvprng_id_get(vprng_unused cvprng_t*  prng) { return 0; }
+  *prng = t;
+}
 
-uint64_t vprng_pos_get(vprng_t* prng)
+void cvprng_split(cvprng_t* parent, cvprng_t* child)
+{
+  vprng_init_hash(&child->base, vprng_cast_u64(cvprng_u32x8(parent)));
+  cvprng_f2_init(child->f2);
+}
+
+// same as vprng_derive on the base generator
+void cvprng_derive(cvprng_t* prng, const cvprng_t* root, const uint64_t path[], uint32_t depth)
 {
-  // temp hack: no need to compute modinv
-  return prng->state[0] * vprng_modinv(vprng_inc(prng)[0]) - 1;
+  vprng_derive(&prng->base, &root->base, path, depth);
+  cvprng_f2_init(prng->f2);
 }
 
 #endif
 
+#else
+extern void vprng_init(vprng_t* prng);
 
-// moves position in stream by 'off'
-void vprng_pos_inc(vprng_t* prng, uint64_t off)
+void vprng_init_n(vprng_t* prng, size_t n)
 {
-  prng->state += vprng_inc(prng) * off;
+  for(size_t i=0; i<n; i++) vprng_init(prng+i);
 }
 
-// set the stream to position 'pos'
-void vprng_pos_set(vprng_t* prng, uint64_t pos)
+void cvprng_init_n(cvprng_t* prng, size_t n)
 {
-  vprng_pos_init(prng);
-  vprng_pos_inc(prng,pos);
+  for(size_t i=0; i<n; i++) {
+    vprng_init(&prng[i].base);
+    cvprng_f2_init(prng[i].f2);
+  }
 }
+#endif
 
-#else
-extern void     vprng_global_id_set(uint64_t id);
-extern uint64_t vprng_global_id_get(void);
-
-extern void     vprng_init (vprng_t* prng);
-extern void     cvprng_init(cvprng_t* prng);
-
-extern uint64_t vprng_id_get (vprng_t* prng);
-extern uint64_t cvprng_id_get(cvprng_t* prng);
 
-extern uint64_t vprng_pos_get(vprng_t* prng);
-extern void     vprng_pos_set(vprng_t* prng, uint64_t pos);
-extern void     vprng_pos_off(vprng_t* prng, uint64_t pos);
+void cvprng_init(cvprng_t* prng)
+{
+  vprng_init(&(prng->base));
+  cvprng_f2_init(prng->f2);
+}
 
-static inline uint64_t cvprng_pos_get(cvprng_t* prng) { return vprng_pos_get(&(prng->base)); }
 
-#endif
+#if !(defined(VPRNG_HIGHLANDER)||defined(VPRNG_ADDITIVE_CONSTANT_EXTERN))
 
+uint64_t vprng_id_get(vprng_t* prng)
+{
+  // multiply by mod-inverse and nuke the "to odd" transform
+  return (vprng_internal_inc_i*prng->inc[0])>>1;
+}
 
-//*******************************************************************
+uint64_t cvprng_id_get(cvprng_t* prng)
+{
+  return vprng_id_get(&prng->base);
+}
+
+#else
+
+uint64_t vprng_id_get (vprng_unused vprng_t*   prng) { return 0; }
+uint64_t cvprng_id_get(vprng_unused cvprng_t*  prng) { return 0; }
+
+#endif
+
+// compile time select position functions. the defaults
+// assume the state update is a Weyl sequence. a variant
+// (VPRNG_POS_EXTERNAL) provides vprng_pos_get_v & vprng_pos_inc_v
+#if !defined(VPRNG_POS_EXTERNAL)
+
+// mod-inverse of each lane
+static inline u64x4_t vprng_modinv_u64x4(u64x4_t a)
+{
+  u64x4_t x = (3*a)^2; 
+  u64x4_t y = 1 - a*x;
+  x = x*(1+y); y *= y;
+  x = x*(1+y); y *= y;
+  x = x*(1+y); y *= y;
+  x = x*(1+y);
+
+  return x;
+}
+
+// position in stream of each lane
+u64x4_t vprng_pos_get_v(vprng_t* prng)
+{
+  vprng_t t = *prng;
+  u64x4_t i = vprng_inc(prng);
+
+  vprng_pos_init(&t);
+
+  return (prng->state - t.state) * vprng_modinv_u64x4(i);
+}
+
+// moves position in stream of each lane by 'off'
+void vprng_pos_inc_v(vprng_t* prng, u64x4_t off)
+{
+  prng->state += vprng_inc(prng) * off;
+}
+
+#else
+u64x4_t  vprng_pos_get_v(vprng_t* prng);
+void     vprng_pos_inc_v(vprng_t* prng, u64x4_t off);
+#endif
+
+// get the current position in the stream
+uint64_t vprng_pos_get(vprng_t* prng)
+{
+  return vprng_pos_get_v(prng)[0];
+}
+
+// moves position in stream by 'off'
+void vprng_pos_inc(vprng_t* prng, uint64_t off)
+{
+  vprng_pos_inc_v(prng, vprng_splat_u64(off));
+}
+
+// set the stream to position 'pos'
+void vprng_pos_set(vprng_t* prng, uint64_t pos)
+{
+  vprng_pos_init(prng);
+  vprng_pos_inc(prng,pos);
+}
+
+// set each lane to its own position. (counter based usage: lane 'i'
+// at position pos[i] in a single call)
+void vprng_pos_set_v(vprng_t* prng, u64x4_t pos)
+{
+  vprng_pos_init(prng);
+  vprng_pos_inc_v(prng,pos);
+}
+
+// position of a single lane (0-3) of the stream. A lane is an
+// independent stream which can be seeked on its own. (the two
+// 32-bit halves of a lane share its position)
+uint64_t vprng_lane_pos_get(vprng_t* prng, uint32_t lane)
+{
+  return vprng_pos_get_v(prng)[lane & 3];
+}
+
+void vprng_lane_pos_set(vprng_t* prng, uint32_t lane, uint64_t pos)
+{
+  vprng_t t = *prng;
+
+  vprng_pos_set(&t, pos);
+  prng->state[lane & 3] = t.state[lane & 3];
+}
+
+
+//*******************************************************************
+// F2 (second state) jumps.
+//
+// The state update T is linear so T^n = q(T) where q = x^n mod p and
+// p is the characteristic polynomial of T (Cayley-Hamilton). 
+// * p is found once (lazily) by Berlekamp-Massey on the low bit
+//   of the first word of lane 0. This requires the update to be full
+//   period (p primitive) which is required anyway. Works for the 2 & 3
+//   term, multiple word and external (VPRNG_STATE2_EXTERNAL) updates.
+// * x^n mod p: carry-less products (PCLMULQDQ/PMULL if available)
+//   and Barrett reduction of the x^(2^k) mod p for the set bits of n.
+// * q(T)s is Horner evaluated: 64w steps on all lanes at once.
+
+#include <stdatomic.h>
+
+#if defined(__PCLMUL__)
+#include <wmmintrin.h>
+#elif defined(__ARM_FEATURE_AES)
+#include <arm_neon.h>
+#endif
+
+#define VPRNG_F2_WORDS  VPRNG_STATE_WORDS
+#define VPRNG_F2_DEGREE (64*VPRNG_F2_WORDS)
+
+// p = x^D + c, mu = floor(x^2D/p) = x^D + m (D = VPRNG_F2_DEGREE)
+// and x2k[k] = x^(2^k) mod p
+static struct {
+  uint64_t c[VPRNG_F2_WORDS];
+  uint64_t m[VPRNG_F2_WORDS];
+  uint64_t x2k[64][VPRNG_F2_WORDS];
+} vprng_f2_poly;
+
+static _Atomic uint32_t vprng_f2_poly_state = 0;
+
+// 64x64 -> 128 carry-less product (software)
+static inline uint64_t vprng_clmul64_sw(uint64_t a, uint64_t b, uint64_t* hi)
+{
+  uint64_t l = a & -(b & 1);
+  uint64_t h = 0;
+
+  for(uint32_t i=1; i<64; i++) {
+    uint64_t m = -((b >> i) & 1);
+    l ^= (a << i) & m;
+    h ^= (a >> (64-i)) & m;
+  }
+
+  *hi = h;
+  return l;
+}
+
+static inline uint64_t vprng_clmul64(uint64_t a, uint64_t b, uint64_t* hi)
+{
+#if defined(__PCLMUL__)
+  __m128i r = _mm_clmulepi64_si128(_mm_cvtsi64_si128((int64_t)a), _mm_cvtsi64_si128((int64_t)b), 0);
+  *hi = (uint64_t)_mm_cvtsi128_si64(_mm_srli_si128(r,8));
+  return (uint64_t)_mm_cvtsi128_si64(r);
+#elif defined(__ARM_FEATURE_AES)
+  uint64x2_t r = vreinterpretq_u64_p128(vmull_p64((poly64_t)a, (poly64_t)b));
+  *hi = vgetq_lane_u64(r,1);
+  return vgetq_lane_u64(r,0);
+#else
+  return vprng_clmul64_sw(a,b,hi);
+#endif  
+}
+
+// r = a*b (r is 2w words)
+static inline void vprng_f2_poly_mul(uint64_t r[static 2*VPRNG_F2_WORDS],
+				     const uint64_t a[static VPRNG_F2_WORDS],
+				     const uint64_t b[static VPRNG_F2_WORDS])
+{
+  memset(r, 0, 2*VPRNG_F2_WORDS*sizeof(uint64_t));
+
+  for(uint32_t i=0; i<VPRNG_F2_WORDS; i++) {
+    for(uint32_t j=0; j<VPRNG_F2_WORDS; j++) {
+      uint64_t h;
+      r[i+j  ] ^= vprng_clmul64(a[i],b[j],&h);
+      r[i+j+1] ^= h;
+    }
+  }
+}
+
+// r = a*b mod p (Barrett: q = floor(H*mu/x^D) where a*b = H x^D + L)
+static void vprng_f2_poly_mulmod(uint64_t r[static VPRNG_F2_WORDS],
+				 const uint64_t a[static VPRNG_F2_WORDS],
+				 const uint64_t b[static VPRNG_F2_WORDS])
+{
+  const uint32_t W = VPRNG_F2_WORDS;
+  
+  uint64_t t[2*VPRNG_F2_WORDS];
+  uint64_t u[2*VPRNG_F2_WORDS];
+  uint64_t q[VPRNG_F2_WORDS];
+
+  vprng_f2_poly_mul(t,a,b);
+  vprng_f2_poly_mul(u,t+W,vprng_f2_poly.m);
+
+  for(uint32_t i=0; i<W; i++) q[i] = t[W+i] ^ u[W+i];
+  
+  vprng_f2_poly_mul(u,q,vprng_f2_poly.c);
+
+  for(uint32_t i=0; i<W; i++) r[i] = t[i] ^ u[i];
+}
+
+// r = r*x mod p
+static inline void vprng_f2_poly_mulx(uint64_t r[static VPRNG_F2_WORDS])
+{
+  uint64_t c = r[VPRNG_F2_WORDS-1] >> 63;
+
+  for(uint32_t i=VPRNG_F2_WORDS-1; i>0; i--)
+    r[i] = (r[i] << 1) | (r[i-1] >> 63);
+  
+  r[0] <<= 1;
+
+  if (c)
+    for(uint32_t i=0; i<VPRNG_F2_WORDS; i++) r[i] ^= vprng_f2_poly.c[i];
+}
+
+// r = x^n mod p: product of the x^(2^k) for the set bits of 'n'
+// as a balanced tree (independent products instead of a chain of
+// dependent squarings)
+static void vprng_f2_poly_xpow(uint64_t r[static VPRNG_F2_WORDS], uint64_t n)
+{
+  uint64_t f[64][VPRNG_F2_WORDS];
+  uint32_t c = 0;
+
+  memset(r, 0, sizeof(uint64_t)*VPRNG_F2_WORDS);
+  r[0] = 1;
+
+  if (n == 0) return;
+
+  while (n != 0) {
+    memcpy(f[c++], vprng_f2_poly.x2k[__builtin_ctzll(n)], sizeof(f[0]));
+    n &= n-1;
+  }
+
+  while (c > 1) {
+    uint32_t h = c >> 1;
+    
+    for(uint32_t i=0; i<h; i++)
+      vprng_f2_poly_mulmod(f[i], f[2*i], f[2*i+1]);
+
+    if (c & 1) memcpy(f[h], f[c-1], sizeof(f[0]));
+
+    c = h + (c & 1);
+  }
+
+  memcpy(r, f[0], sizeof(f[0]));
+}
+
+// bit helpers for arbitrary length polynomials (w+1 words)
+static inline uint32_t vprng_f2_bit(const uint64_t* a, uint32_t i)
+{
+  return (uint32_t)(a[i>>6] >> (i & 63)) & 1;
+}
+
+static inline void vprng_f2_bit_flip(uint64_t* a, uint32_t i)
+{
+  a[i>>6] ^= UINT64_C(1) << (i & 63);
+}
+
+// finds p & mu
+static void vprng_f2_poly_init(void)
+{
+  enum { D = VPRNG_F2_DEGREE, W = VPRNG_F2_WORDS };
+  
+  // 0:not built, 1:in progress, 2:ready
+  uint32_t e = 0;
+
+  if (atomic_load_explicit(&vprng_f2_poly_state, memory_order_acquire) == 2) return;
+
+  if (atomic_compare_exchange_strong(&vprng_f2_poly_state, &e, 1)) {
+    uint64_t s[2*W];             // 2D bits of the sequence
+    uint64_t c[W+1] = {1};       // connection polynomial
+    uint64_t b[W+1] = {1};
+    uint64_t t[W+1];
+    uint64_t r[2*W+1] = {0};     // for the division
+    u64x4_t  v[W];
+    uint32_t L = 0, m = 1;
+
+    cvprng_f2_init(v);
+
+    memset(s,0,sizeof(s));
+
+    for(uint32_t i=0; i<2*D; i++) {
+      s[i>>6] |= (v[0][0] & 1) << (i & 63);
+      cvprng_state_up_w(v);
+    }
+
+    // Berlekamp-Massey
+    for(uint32_t i=0; i<2*D; i++) {
+      uint32_t d = vprng_f2_bit(s,i);
+
+      for(uint32_t j=1; j<=L; j++)
+	d ^= vprng_f2_bit(c,j) & vprng_f2_bit(s,i-j);
+
+      if (d == 0) { m++; continue; }
+
+      memcpy(t,c,sizeof(c));
+
+      for(uint32_t j=0; j+m<=D; j++)
+	if (vprng_f2_bit(b,j)) vprng_f2_bit_flip(c,j+m);
+
+      if (2*L <= i) { L = i+1-L; memcpy(b,t,sizeof(t)); m = 1; }
+      else m++;
+    }
+
+    assert(L == D);
+
+    // p is the reciprocal of c: p_k = c_(D-k)
+    memset(vprng_f2_poly.c, 0, sizeof(vprng_f2_poly.c));
+    
+    for(uint32_t k=0; k<D; k++)
+      if (vprng_f2_bit(c,D-k)) vprng_f2_bit_flip(vprng_f2_poly.c,k);
+
+    // mu: long division of x^2D by p (only need the quotient)
+    memset(vprng_f2_poly.m, 0, sizeof(vprng_f2_poly.m));
+    vprng_f2_bit_flip(r,2*D);
+
+    for(int32_t k=D; k>=0; k--) {
+      if (!vprng_f2_bit(r,(uint32_t)k+D)) continue;
+
+      if (k < D) vprng_f2_bit_flip(vprng_f2_poly.m,(uint32_t)k);
+
+      vprng_f2_bit_flip(r,(uint32_t)k+D);
+      
+      for(uint32_t j=0; j<D; j++)
+	if (vprng_f2_bit(vprng_f2_poly.c,j)) vprng_f2_bit_flip(r,j+(uint32_t)k);
+    }
+
+    // x^(2^k) by repeated squaring
+    memset(vprng_f2_poly.x2k[0], 0, sizeof(vprng_f2_poly.x2k[0]));
+    vprng_f2_poly.x2k[0][0] = 2;
+
+    for(uint32_t k=1; k<64; k++)
+      vprng_f2_poly_mulmod(vprng_f2_poly.x2k[k], vprng_f2_poly.x2k[k-1], vprng_f2_poly.x2k[k-1]);
+
+    atomic_store_explicit(&vprng_f2_poly_state, 2, memory_order_release);
+    return;
+  }
+
+  while(atomic_load_explicit(&vprng_f2_poly_state, memory_order_acquire) != 2);
+}
+
+// moves the F2 state 'n' steps forward
+void cvprng_f2_jump(u64x4_t s[static VPRNG_STATE_WORDS], uint64_t n)
+{
+  uint64_t q[VPRNG_F2_WORDS];
+  u64x4_t  r[VPRNG_F2_WORDS] = {{0}};
+
+  vprng_f2_poly_init();
+  vprng_f2_poly_xpow(q, n);
+
+  // Horner: r = T(r) + q_j s
+  for(int32_t j=VPRNG_F2_DEGREE-1; j>=0; j--) {
+    uint64_t m = -(uint64_t)vprng_f2_bit(q,(uint32_t)j);
+    
+    cvprng_state_up_w(r);
+    
+    for(uint32_t k=0; k<VPRNG_F2_WORDS; k++) r[k] ^= s[k] & m;
+  }
+
+  memcpy(s, r, sizeof(r));
+}
+
+// set the stream to position 'pos'
+void cvprng_pos_set(cvprng_t* prng, uint64_t pos)
+{
+  vprng_pos_set(&prng->base, pos);
+  cvprng_f2_init(prng->f2);
+  cvprng_f2_jump(prng->f2, pos);
+}
+
+
+//*******************************************************************
+// serialization: 24 byte (VPRNG_SERIAL_BYTES) little endian
+//   byte  0    : format version (VPRNG_SERIAL_VERSION)
+//   byte  1    : VPRNG_VARIANT_ID, bit 7 set if cvprng with
+//                bits 5-6 = log2(VPRNG_STATE_WORDS)
+//   bytes 2-7  : 16-bit id deltas of lanes 1-3 from lane 0
+//   bytes 8-15 : id of lane 0
+//   bytes 16-23: position in stream
+//
+// this is only possible for generators whose additive constants
+// were produced by the default method (any id) with lane ids
+// close together (like those from 'vprng_init') and that are
+// at a common position in the stream (and the F2 state is at
+// the same position from its initial value). Serialization verifies
+// the result round-trips and returns 0 if not representable.
+
+#define VPRNG_SERIAL_VERSION 1
+#define VPRNG_SERIAL_CTAG    (VPRNG_VARIANT_ID | 0x80 | ((VPRNG_STATE_WORDS >> 1) << 5))
+
+static inline void vprng_store_le64(uint8_t* d, uint64_t v)
+{
+  for(uint32_t i=0; i<8; i++) { d[i] = (uint8_t)v; v >>= 8; }
+}
+
+static inline uint64_t vprng_load_le64(const uint8_t* d)
+{
+  uint64_t v = 0;
+  for(uint32_t i=0; i<8; i++) v |= (uint64_t)d[i] << (8*i);
+  return v;
+}
+
+#if !(defined(VPRNG_HIGHLANDER)||defined(VPRNG_ADDITIVE_CONSTANT_EXTERN))
+
+static inline uint64_t vprng_serial_lane_id(uint64_t inc) { return (vprng_internal_inc_i*inc)>>1; }
+static inline uint64_t vprng_serial_lane_inc(uint64_t id) { return ((id<<1)|1)*vprng_internal_inc_k; }
+
+static uint32_t vprng_serial_encode(uint8_t d[static VPRNG_SERIAL_BYTES], vprng_t* prng, uint32_t tag)
+{
+  uint64_t id0 = vprng_serial_lane_id(prng->inc[0]);
+
+  d[0] = VPRNG_SERIAL_VERSION;
+  d[1] = (uint8_t)tag;
+  
+  for(uint32_t i=1; i<4; i++) {
+    uint64_t delta = vprng_serial_lane_id(prng->inc[i]) - id0;
+    if (delta > 0xffff) return 0;
+    d[2*i  ] = (uint8_t)(delta);
+    d[2*i+1] = (uint8_t)(delta >> 8);
+  }
+
+  vprng_store_le64(d+ 8, id0);
+  vprng_store_le64(d+16, vprng_pos_get(prng));
+
+  return VPRNG_SERIAL_BYTES;
+}
+
+static uint32_t vprng_serial_decode(vprng_t* prng, const uint8_t d[static VPRNG_SERIAL_BYTES], uint32_t tag)
+{
+  if ((d[0] != VPRNG_SERIAL_VERSION) || (d[1] != tag)) return 0;
+
+  uint64_t id0 = vprng_load_le64(d+8);
+
+  prng->inc[0] = vprng_serial_lane_inc(id0);
+  
+  for(uint32_t i=1; i<4; i++) {
+    uint64_t delta = (uint64_t)d[2*i] | ((uint64_t)d[2*i+1] << 8);
+    prng->inc[i] = vprng_serial_lane_inc(id0+delta);
+  }
+  
+  vprng_init_extra(prng);
+  vprng_pos_set(prng, vprng_load_le64(d+16));
+  
+  return VPRNG_SERIAL_BYTES;
+}
+
+// returns VPRNG_SERIAL_BYTES on success and zero if 'prng' isn't representable
+uint32_t vprng_serialize(uint8_t d[static VPRNG_SERIAL_BYTES], vprng_t* prng)
+{
+  vprng_t t;
+  
+  if (vprng_serial_encode(d, prng, VPRNG_VARIANT_ID) == 0) return 0;
+  if (vprng_serial_decode(&t, d,   VPRNG_VARIANT_ID) == 0) return 0;
+
+  return memcmp(&t, prng, sizeof(vprng_t)) == 0 ? VPRNG_SERIAL_BYTES : 0;
+}
+
+// returns VPRNG_SERIAL_BYTES on success and zero if 'd' is malformed
+// or from another variant/generator type.
+uint32_t vprng_deserialize(vprng_t* prng, const uint8_t d[static VPRNG_SERIAL_BYTES])
+{
+  return vprng_serial_decode(prng, d, VPRNG_VARIANT_ID);
+}
+
+uint32_t cvprng_deserialize(cvprng_t* prng, const uint8_t d[static VPRNG_SERIAL_BYTES])
+{
+  if (vprng_serial_decode(&prng->base, d, VPRNG_SERIAL_CTAG) == 0) return 0;
+
+  cvprng_f2_init(prng->f2);
+  cvprng_f2_jump(prng->f2, vprng_load_le64(d+16));
+
+  return VPRNG_SERIAL_BYTES;
+}
+
+uint32_t cvprng_serialize(uint8_t d[static VPRNG_SERIAL_BYTES], cvprng_t* prng)
+{
+  cvprng_t t;
+  
+  if (vprng_serial_encode(d, &prng->base, VPRNG_SERIAL_CTAG) == 0) return 0;
+  if (cvprng_deserialize(&t, d) == 0) return 0;
+  
+  return memcmp(&t, prng, sizeof(cvprng_t)) == 0 ? VPRNG_SERIAL_BYTES : 0;
+}
+
+#else
+
+// additive constants aren't from the default method
+uint32_t  vprng_serialize  (vprng_unused uint8_t* d, vprng_unused vprng_t*  prng) { return 0; }
+uint32_t cvprng_serialize  (vprng_unused uint8_t* d, vprng_unused cvprng_t* prng) { return 0; }
+uint32_t  vprng_deserialize(vprng_unused vprng_t*  prng, vprng_unused const uint8_t* d) { return 0; }
+uint32_t cvprng_deserialize(vprng_unused cvprng_t* prng, vprng_unused const uint8_t* d) { return 0; }
+
+#endif
+
+// batch forms: returns the number of generators processed, which is
+// 'n' on success otherwise the index of the first failure.
+uint32_t vprng_serialize_n(uint32_t n, uint8_t d[static n*VPRNG_SERIAL_BYTES], vprng_t prng[static n])
+{
+  for(uint32_t i=0; i<n; i++, d += VPRNG_SERIAL_BYTES)
+    if (vprng_serialize(d, prng+i) == 0) return i;
+  return n;
+}
+
+uint32_t vprng_deserialize_n(uint32_t n, vprng_t prng[static n], const uint8_t d[static n*VPRNG_SERIAL_BYTES])
+{
+  for(uint32_t i=0; i<n; i++, d += VPRNG_SERIAL_BYTES)
+    if (vprng_deserialize(prng+i, d) == 0) return i;
+  return n;
+}
+
+uint32_t cvprng_serialize_n(uint32_t n, uint8_t d[static n*VPRNG_SERIAL_BYTES], cvprng_t prng[static n])
+{
+  for(uint32_t i=0; i<n; i++, d += VPRNG_SERIAL_BYTES)
+    if (cvprng_serialize(d, prng+i) == 0) return i;
+  return n;
+}
+
+uint32_t cvprng_deserialize_n(uint32_t n, cvprng_t prng[static n], const uint8_t d[static n*VPRNG_SERIAL_BYTES])
+{
+  for(uint32_t i=0; i<n; i++, d += VPRNG_SERIAL_BYTES)
+    if (cvprng_deserialize(prng+i, d) == 0) return i;
+  return n;
+}
+
+#else
+extern void     vprng_global_id_set(uint64_t id);
+extern uint64_t vprng_global_id_get(void);
+extern void     vprng_global_id_bind(_Atomic uint64_t* counter);
+extern void     vprng_thread_id_lease(uint32_t bits);
+extern void     vprng_thread_id_range(uint64_t id, uint64_t n);
+extern void     vprng_thread_id_release(void);
+
+extern void     vprng_init (vprng_t* prng);
+extern void     cvprng_init(cvprng_t* prng);
+extern void     vprng_init_n (vprng_t* prng,  size_t n);
+extern void     cvprng_init_n(cvprng_t* prng, size_t n);
+
+extern void     vprng_index_init (vprng_index_t* index, uint32_t* count, uint64_t n, uint64_t base);
+extern void     vprng_init_index (vprng_t* prng,  const vprng_index_t* index, uint64_t k);
+extern void     cvprng_init_index(cvprng_t* prng, const vprng_index_t* index, uint64_t k);
+
+extern void     vprng_split  (vprng_t*  parent, vprng_t*  child);
+extern void     cvprng_split (cvprng_t* parent, cvprng_t* child);
+extern void     vprng_derive (vprng_t*  prng, const vprng_t*  root, const uint64_t path[], uint32_t depth);
+extern void     cvprng_derive(cvprng_t* prng, const cvprng_t* root, const uint64_t path[], uint32_t depth);
+
+extern uint64_t vprng_id_get (vprng_t* prng);
+extern uint64_t cvprng_id_get(cvprng_t* prng);
+
+extern uint64_t vprng_pos_get(vprng_t* prng);
+extern u64x4_t  vprng_pos_get_v(vprng_t* prng);
+extern uint64_t vprng_lane_pos_get(vprng_t* prng, uint32_t lane);
+extern void     vprng_lane_pos_set(vprng_t* prng, uint32_t lane, uint64_t pos);
+extern void     vprng_pos_set(vprng_t* prng, uint64_t pos);
+extern void     vprng_pos_inc(vprng_t* prng, uint64_t off);
+extern void     vprng_pos_inc_v(vprng_t* prng, u64x4_t off);
+extern void     vprng_pos_set_v(vprng_t* prng, u64x4_t pos);
+extern void     cvprng_pos_set(cvprng_t* prng, uint64_t pos);
+extern void     cvprng_f2_jump(u64x4_t s[static VPRNG_STATE_WORDS], uint64_t n);
+
+extern uint32_t  vprng_serialize  (uint8_t d[static VPRNG_SERIAL_BYTES], vprng_t*  prng);
+extern uint32_t cvprng_serialize  (uint8_t d[static VPRNG_SERIAL_BYTES], cvprng_t* prng);
+extern uint32_t  vprng_deserialize(vprng_t*  prng, const uint8_t d[static VPRNG_SERIAL_BYTES]);
+extern uint32_t cvprng_deserialize(cvprng_t* prng, const uint8_t d[static VPRNG_SERIAL_BYTES]);
+
+extern uint32_t  vprng_serialize_n  (uint32_t n, uint8_t d[static n*VPRNG_SERIAL_BYTES], vprng_t  prng[static n]);
+extern uint32_t cvprng_serialize_n  (uint32_t n, uint8_t d[static n*VPRNG_SERIAL_BYTES], cvprng_t prng[static n]);
+extern uint32_t  vprng_deserialize_n(uint32_t n, vprng_t  prng[static n], const uint8_t d[static n*VPRNG_SERIAL_BYTES]);
+extern uint32_t cvprng_deserialize_n(uint32_t n, cvprng_t prng[static n], const uint8_t d[static n*VPRNG_SERIAL_BYTES]);
+
+#endif
+
+// position of the combined generator is that of the base
+static inline uint64_t cvprng_pos_get(cvprng_t* prng) { return vprng_pos_get(&(prng->base)); }
+
+
+//*******************************************************************
 // Stripped down "portable" 256 bit SIMD via vector_size extension
 
 // routines for strict aliasing happpy conversion.
@@ -786,3 +1913,265 @@ static inline void cvprng_block_fill_u32(uint32_t n, u32x8_t buffer[static n], c
   for(uint32_t i=0; i<n; i++) { buffer[i] = cvprng_u32x8(prng); }
 }
 
+
+//*******************************************************************
+// hashing with the bit finalizers (both are bijections). Unlike
+// the generator usage every lane uses the same function so a key's
+// hash doesn't depend on its position in a batch:
+// * vprng_hash_*:       default finalizer with the lane 0 constants
+// * vprng_hash_mix14_*: MIX14 (SplitMix64's finalizer)
+// Seeded versions XOR the seed (can be per lane) into the keys: a
+// seed of zero is the unseeded hash. vprng_unhash_* are the inverses
+// (recovers the key) at about the same cost.
+
+static inline u64x4_t vprng_hash_u64x4_seeded(u64x4_t k, u64x4_t seed)
+{
+  u64x4_t m0 = vprng_splat_u64(vprng_cast_u64(vprng_finalize_m0)[0]);
+  u64x4_t m1 = vprng_splat_u64(vprng_cast_u64(vprng_finalize_m1)[0]);
+
+  return vprng_finalize_k(k^seed, vprng_cast_u32(m0), vprng_cast_u32(m1));
+}
+
+static inline u64x4_t vprng_hash_mix14_u64x4_seeded(u64x4_t k, u64x4_t seed)
+{
+  return vprng_mix14(k^seed);
+}
+
+static inline u64x4_t vprng_hash_u64x4(u64x4_t k)
+{
+  return vprng_hash_u64x4_seeded(k, vprng_splat_u64(0));
+}
+
+static inline u64x4_t vprng_hash_mix14_u64x4(u64x4_t k)
+{
+  return vprng_mix14(k);
+}
+
+static inline uint64_t vprng_hash_u64(uint64_t k, uint64_t seed)
+{
+  return vprng_hash_u64x4_seeded(vprng_splat_u64(k), vprng_splat_u64(seed))[0];
+}
+
+static inline uint64_t vprng_hash_mix14_u64(uint64_t k, uint64_t seed)
+{
+  return vprng_mix14(vprng_splat_u64(k^seed))[0];
+}
+
+// inverses of the seeded hashes (key recovery)
+static inline u64x4_t vprng_unhash_u64x4_seeded(u64x4_t h, u64x4_t seed)
+{
+  u64x4_t i0 = vprng_splat_u64(vprng_cast_u64(vprng_finalize_i0)[0]);
+  u64x4_t i1 = vprng_splat_u64(vprng_cast_u64(vprng_finalize_i1)[0]);
+
+  return vprng_finalize_inv_k(h, vprng_cast_u32(i0), vprng_cast_u32(i1))^seed;
+}
+
+static inline u64x4_t vprng_unhash_mix14_u64x4_seeded(u64x4_t h, u64x4_t seed)
+{
+  return vprng_mix14_inv(h)^seed;
+}
+
+static inline u64x4_t vprng_unhash_u64x4(u64x4_t h)
+{
+  return vprng_unhash_u64x4_seeded(h, vprng_splat_u64(0));
+}
+
+static inline u64x4_t vprng_unhash_mix14_u64x4(u64x4_t h)
+{
+  return vprng_mix14_inv(h);
+}
+
+static inline uint64_t vprng_unhash_u64(uint64_t h, uint64_t seed)
+{
+  return vprng_unhash_u64x4_seeded(vprng_splat_u64(h), vprng_splat_u64(seed))[0];
+}
+
+static inline uint64_t vprng_unhash_mix14_u64(uint64_t h, uint64_t seed)
+{
+  return vprng_mix14_inv(vprng_splat_u64(h))[0]^seed;
+}
+
+// out[i] = f(in[i],seed) for i<n (in-place is fine)
+static inline void vprng_hash_batch_f(const uint64_t* in, uint64_t* out, size_t n, uint64_t seed,
+				      u64x4_t (*f)(u64x4_t, u64x4_t))
+{
+  u64x4_t s = vprng_splat_u64(seed);
+  size_t  i = 0;
+
+  for(; i+4 <= n; i+=4) {
+    u64x4_t k; memcpy(&k, in+i, sizeof(k));
+    k = f(k, s);
+    memcpy(out+i, &k, sizeof(k));
+  }
+
+  if (i < n) {
+    u64x4_t k = {0};
+    memcpy(&k, in+i, (n-i)*sizeof(uint64_t));
+    k = f(k, s);
+    memcpy(out+i, &k, (n-i)*sizeof(uint64_t));
+  }
+}
+
+static inline void vprng_hash_batch(const uint64_t* in, uint64_t* out, size_t n, uint64_t seed)
+{
+  vprng_hash_batch_f(in, out, n, seed, vprng_hash_u64x4_seeded);
+}
+
+static inline void vprng_hash_mix14_batch(const uint64_t* in, uint64_t* out, size_t n, uint64_t seed)
+{
+  vprng_hash_batch_f(in, out, n, seed, vprng_hash_mix14_u64x4_seeded);
+}
+
+static inline void vprng_unhash_batch(const uint64_t* in, uint64_t* out, size_t n, uint64_t seed)
+{
+  vprng_hash_batch_f(in, out, n, seed, vprng_unhash_u64x4_seeded);
+}
+
+static inline void vprng_unhash_mix14_batch(const uint64_t* in, uint64_t* out, size_t n, uint64_t seed)
+{
+  vprng_hash_batch_f(in, out, n, seed, vprng_unhash_mix14_u64x4_seeded);
+}
+
+
+//*******************************************************************
+// lane streams: each 64-bit lane (vprng_lanes64_t) or 32-bit lane
+// (vprng_lanes32_t) is used as its own scalar generator. Consumers
+// pull from their lane and empty lanes are refilled together with
+// one vector step per VPRNG_LANE_BUFFER values. A refill only
+// advances the lanes being refilled so a lane's stream is exactly
+// the sequence of that lane's output (no matter how the others are
+// consumed) and each lane can be seeked independently.
+//
+// 64-bit lane 'l' is lane 'l' of vprng_u64x4. 32-bit lane 'l' is
+// lane 'l' of vprng_u32x8: the even and odd 32-bit lanes are drawn
+// from separate copies of the generator so all eight are
+// independently positioned. The cost is 2x: each copy's steps use
+// only half of the u32x8_t (the other half is masked away) so a full
+// refill is 2*VPRNG_LANE_BUFFER vector steps. The two halves of a
+// 64-bit lane come from one state update so a shared generator
+// would tie the positions of each even/odd pair together.
+//
+// Requires independent lanes (not vprng_aes)
+
+#if !defined(VPRNG_STATE_EXTERNAL) || defined(VPRNG_POS_EXTERNAL)
+
+#if !defined(VPRNG_LANE_BUFFER)
+#define VPRNG_LANE_BUFFER 8
+#endif
+
+typedef struct {
+  vprng_t  prng;
+  u64x4_t  buf[VPRNG_LANE_BUFFER];
+  uint32_t n[4];                       // unread values per lane
+} vprng_lanes64_t;
+
+typedef struct {
+  vprng_t  prng[2];                    // even & odd lanes
+  u32x8_t  buf[VPRNG_LANE_BUFFER];
+  uint32_t n[8];
+} vprng_lanes32_t;
+
+// vprng_u32x8 which only advances the lanes set in 'm'
+static inline u32x8_t vprng_u32x8_masked(vprng_t* prng, u64x4_t m)
+{
+  vprng_t t = *prng;
+  u32x8_t r = vprng_u32x8(&t);
+  
+  prng->state = (t.state & m) | (prng->state & ~m);
+
+  return r;
+}
+
+static inline void vprng_lanes64_init(vprng_lanes64_t* l, const vprng_t* prng)
+{
+  memset(l, 0, sizeof(vprng_lanes64_t));
+  l->prng = *prng;
+}
+
+static inline void vprng_lanes32_init(vprng_lanes32_t* l, const vprng_t* prng)
+{
+  memset(l, 0, sizeof(vprng_lanes32_t));
+  l->prng[0] = *prng;
+  l->prng[1] = *prng;
+}
+
+// refills all empty lanes
+static inline void vprng_lanes64_refill(vprng_lanes64_t* l)
+{
+  u64x4_t m = {0};
+
+  for(uint32_t i=0; i<4; i++) {
+    if (l->n[i] != 0) continue;
+    m[i]    = UINT64_C(~0);
+    l->n[i] = VPRNG_LANE_BUFFER;
+  }
+
+  for(uint32_t j=0; j<VPRNG_LANE_BUFFER; j++) {
+    u64x4_t r = vprng_cast_u64(vprng_u32x8_masked(&l->prng, m));
+    l->buf[j] = (r & m) | (l->buf[j] & ~m);
+  }
+}
+
+static inline void vprng_lanes32_refill(vprng_lanes32_t* l)
+{
+  for(uint32_t h=0; h<2; h++) {
+    u64x4_t m = {0};
+    u32x8_t k = {0};
+
+    for(uint32_t i=0; i<4; i++) {
+      uint32_t c = 2*i+h;
+      if (l->n[c] != 0) continue;
+      m[i]    = UINT64_C(~0);
+      k[c]    = ~UINT32_C(0);
+      l->n[c] = VPRNG_LANE_BUFFER;
+    }
+
+    if (k[0]|k[1]|k[2]|k[3]|k[4]|k[5]|k[6]|k[7]) {
+      for(uint32_t j=0; j<VPRNG_LANE_BUFFER; j++) {
+	u32x8_t r = vprng_u32x8_masked(&l->prng[h], m);
+	l->buf[j] = (r & k) | (l->buf[j] & ~k);
+      }
+    }
+  }
+}
+
+// next value of lane 'i'
+static inline uint64_t vprng_lanes64_next(vprng_lanes64_t* l, uint32_t i)
+{
+  if (l->n[i] == 0) vprng_lanes64_refill(l);
+
+  return l->buf[VPRNG_LANE_BUFFER - l->n[i]--][i];
+}
+
+static inline uint32_t vprng_lanes32_next(vprng_lanes32_t* l, uint32_t i)
+{
+  if (l->n[i] == 0) vprng_lanes32_refill(l);
+
+  return l->buf[VPRNG_LANE_BUFFER - l->n[i]--][i];
+}
+
+// position of lane 'i' (the position of its next value)
+static inline uint64_t vprng_lanes64_pos_get(vprng_lanes64_t* l, uint32_t i)
+{
+  return vprng_lane_pos_get(&l->prng, i) - l->n[i];
+}
+
+static inline void vprng_lanes64_pos_set(vprng_lanes64_t* l, uint32_t i, uint64_t pos)
+{
+  vprng_lane_pos_set(&l->prng, i, pos);
+  l->n[i] = 0;
+}
+
+static inline uint64_t vprng_lanes32_pos_get(vprng_lanes32_t* l, uint32_t i)
+{
+  return vprng_lane_pos_get(&l->prng[i & 1], i >> 1) - l->n[i];
+}
+
+static inline void vprng_lanes32_pos_set(vprng_lanes32_t* l, uint32_t i, uint64_t pos)
+{
+  vprng_lane_pos_set(&l->prng[i & 1], i >> 1, pos);
+  l->n[i] = 0;
+}
+
+#endif
+
@@ -0,0 +1,114 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Fills with non-contiguous destinations: writes directly into a
+// matrix column, a structure of arrays field, a sub-matrix or an
+// index list (no temp buffer + copy pass).
+//
+// * _strided: dst[i*stride]                       (stride in elements)
+// * _2d:      dst[r*pitch+c]   for r<rows, c<cols (pitch in elements)
+// * _scatter: dst[idx[i]]                         (idx[i] < 2^31)
+//
+// Element 'i' (in the order listed) is always value 'i' of the
+// same sequence as a contiguous fill (successive vectors of the
+// generator stored to memory) so the layout doesn't change results.
+// A partially used last vector is discarded: a fill of 'n' elements
+// consumes ceil(n/L) steps where L is the number of lanes.
+//
+// For each: {c}vprng_fill_{u32,u64,f32,f64}_{strided,2d,scatter}.
+// The scatter form uses native scatters with AVX512F+AVX512VL.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "vprng.h"
+
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+#include <immintrin.h>
+#endif
+
+// dst[idx[i]] = v[i] : 32 and 64-bit elements
+static inline void vprng_scatter_x32(void* dst, const uint32_t idx[static 8], u32x8_t v)
+{
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+  __m256i i; memcpy(&i, idx, 32);
+  _mm256_i32scatter_epi32(dst, i, (__m256i)v, 4);
+#else
+  uint32_t* d = (uint32_t*)dst;
+  for(uint32_t j=0; j<8; j++) d[idx[j]] = v[j];
+#endif
+}
+
+static inline void vprng_scatter_x64(void* dst, const uint32_t idx[static 4], u64x4_t v)
+{
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+  __m128i i; memcpy(&i, idx, 16);
+  _mm256_i32scatter_epi64(dst, i, (__m256i)v, 8);
+#else
+  uint64_t* d = (uint64_t*)dst;
+  for(uint32_t j=0; j<4; j++) d[idx[j]] = v[j];
+#endif
+}
+
+// P: prefix, G: generator type, S: suffix, T: element type
+// L: lanes, V: vector type, F: vector function, W: element bits
+#define VPRNG_FILL_DEFINE(P,G,S,T,L,V,F,W)				\
+									\
+static inline void P##_fill_##S##_strided(G* prng, T* dst, size_t n, ptrdiff_t stride) \
+{									\
+  for(size_t i=0; i<n; i+=L) {						\
+    V      v = F(prng);							\
+    size_t m = (n-i < L) ? n-i : L;					\
+    T*     d = dst + (ptrdiff_t)i*stride;				\
+									\
+    for(size_t j=0; j<m; j++) d[(ptrdiff_t)j*stride] = v[j];		\
+  }									\
+}									\
+									\
+static inline void P##_fill_##S##_2d(G* prng, T* dst, size_t rows, size_t cols, size_t pitch) \
+{									\
+  V        v = {0};							\
+  uint32_t k = L;    /* next unused lane of 'v' */			\
+									\
+  for(size_t r=0; r<rows; r++) {					\
+    T*     d = dst + r*pitch;						\
+    size_t c = 0;							\
+									\
+    while (k < L && c < cols) d[c++] = v[k++];				\
+									\
+    for(; c+L <= cols; c+=L) { v = F(prng); memcpy(d+c, &v, sizeof(V)); } \
+									\
+    if (c < cols) {							\
+      v = F(prng); k = 0;						\
+      while (c < cols) d[c++] = v[k++];					\
+    }									\
+  }									\
+}									\
+									\
+static inline void P##_fill_##S##_scatter(G* prng, T* dst, size_t n, const uint32_t idx[static n]) \
+{									\
+  size_t i = 0;								\
+									\
+  for(; i+L <= n; i+=L) {						\
+    V v = F(prng);							\
+    u##W##x##L##_t b; memcpy(&b, &v, sizeof(V));			\
+    vprng_scatter_x##W(dst, idx+i, b);					\
+  }									\
+									\
+  if (i < n) {								\
+    V v = F(prng);							\
+    for(uint32_t j=0; i<n; i++, j++) dst[idx[i]] = v[j];		\
+  }									\
+}
+
+VPRNG_FILL_DEFINE( vprng,  vprng_t, u32, uint32_t, 8, u32x8_t,  vprng_u32x8, 32)
+VPRNG_FILL_DEFINE( vprng,  vprng_t, u64, uint64_t, 4, u64x4_t,  vprng_u64x4, 64)
+VPRNG_FILL_DEFINE( vprng,  vprng_t, f32, float,    8, f32x8_t,  vprng_f32x8, 32)
+VPRNG_FILL_DEFINE( vprng,  vprng_t, f64, double,   4, f64x4_t,  vprng_f64x4, 64)
+VPRNG_FILL_DEFINE(cvprng, cvprng_t, u32, uint32_t, 8, u32x8_t, cvprng_u32x8, 32)
+VPRNG_FILL_DEFINE(cvprng, cvprng_t, u64, uint64_t, 4, u64x4_t, cvprng_u64x4, 64)
+VPRNG_FILL_DEFINE(cvprng, cvprng_t, f32, float,    8, f32x8_t, cvprng_f32x8, 32)
+VPRNG_FILL_DEFINE(cvprng, cvprng_t, f64, double,   4, f64x4_t, cvprng_f64x4, 64)
+
+#undef VPRNG_FILL_DEFINE
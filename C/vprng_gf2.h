@@ -0,0 +1,203 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Minimal self-contained GF(2) 64x64 bit matrix routines. Enough for
+// building/examining F2 state updates (linear part of xorshift like
+// functions), matrix powers and jump tables for 2^k steps. This is
+// an offline/tooling aid (replaces M4RI in tools/xorshift.c). The
+// library itself doesn't use it: cvprng_pos_set & cvprng_f2_jump
+// use the (much cheaper) polynomial jump in vprng.h.
+//
+// Matrices are row major: r[i] is row 'i' and bit 'j' is column 'j'.
+// So y = Mx is: bit 'i' of y = parity(r[i] & x)
+//
+// Products use the "method of four Russians" (M4RM) with 8-bit
+// chunks: for each 8 row chunk of B a table of all 256 XOR
+// combinations is built and each row of A then requires 8 lookups
+// instead of up to 64 row XORs. The lookups are scalar loads (four
+// gathered into a vector) and only the XOR accumulation of four
+// result rows at a time is 256-bit vector work.
+
+#pragma once
+
+#include "vprng.h"
+
+typedef struct { uint64_t r[64]; } vprng_gf2_mat_t;
+
+// jump table: t[k] = M^(2^k), stored transposed (rows are the
+// columns of M^(2^k)) for fast application to vectors.
+typedef struct { vprng_gf2_mat_t t[64]; } vprng_gf2_jump_t;
+
+static inline void vprng_gf2_identity(vprng_gf2_mat_t* m)
+{
+  for(uint32_t i=0; i<64; i++) m->r[i] = UINT64_C(1) << i;
+}
+
+// column 'c' of 'm'
+static inline uint64_t vprng_gf2_col(const vprng_gf2_mat_t* m, uint32_t c)
+{
+  uint64_t r = 0;
+
+  for(uint32_t i=0; i<64; i++) r |= ((m->r[i] >> c) & 1) << i;
+
+  return r;
+}
+
+// linear part of 'f' as a matrix. returns f(0) (the affine part)
+static inline uint64_t vprng_gf2_from_func(vprng_gf2_mat_t* m, uint64_t (*f)(uint64_t))
+{
+  uint64_t t = f(0);
+
+  for(uint32_t i=0; i<64; i++) m->r[i] = 0;
+
+  for(uint32_t c=0; c<64; c++) {
+    uint64_t v = f(UINT64_C(1) << c) ^ t;
+
+    for(uint32_t i=0; i<64; i++) m->r[i] |= ((v >> i) & 1) << c;
+  }
+
+  return t;
+}
+
+// in-place transpose (recursive block swap)
+static inline void vprng_gf2_transpose(vprng_gf2_mat_t* m)
+{
+  uint64_t  s = UINT64_C(0x00000000ffffffff);
+  uint64_t* a = m->r;
+
+  for(uint32_t j=32; j!=0; j>>=1, s ^= s << j) {
+    for(uint32_t k=0; k<64; k = ((k|j)+1) & ~j) {
+      uint64_t t = ((a[k] >> j) ^ a[k|j]) & s;
+      a[k|j] ^= t;
+      a[k]   ^= t << j;
+    }
+  }
+}
+
+// y = Mx
+static inline uint64_t vprng_gf2_apply(const vprng_gf2_mat_t* m, uint64_t x)
+{
+  uint64_t r = 0;
+
+  for(uint32_t i=0; i<64; i++)
+    r |= (uint64_t)(__builtin_popcountll(m->r[i] & x) & 1) << i;
+
+  return r;
+}
+
+// y = M^T x for each lane of 'x'. (if 't' is a transposed matrix
+// then this is 'M x'): XOR of the rows of 't' selected by 'x'
+static inline u64x4_t vprng_gf2_apply_t_x4(const vprng_gf2_mat_t* t, u64x4_t x)
+{
+  u64x4_t r = {0};
+
+  for(uint32_t j=0; j<64; j++) {
+    u64x4_t b = -((x >> j) & 1);
+    r ^= b & t->r[j];
+  }
+  return r;
+}
+
+// r = AB (r can alias a or b)
+static void vprng_gf2_mul(vprng_gf2_mat_t* r, const vprng_gf2_mat_t* a, const vprng_gf2_mat_t* b)
+{
+  uint64_t tbl[8][256];
+  u64x4_t  acc[16];
+
+  // combination tables for each 8 row chunk of B
+  for(uint32_t c=0; c<8; c++) {
+    const uint64_t* br = b->r + 8*c;
+    uint64_t*       t  = tbl[c];
+
+    t[0] = 0;
+
+    for(uint32_t v=1; v<256; v++)
+      t[v] = t[v & (v-1)] ^ br[__builtin_ctz(v)];
+  }
+
+  for(uint32_t i=0; i<64; i+=4) {
+    u64x4_t x = {a->r[i], a->r[i+1], a->r[i+2], a->r[i+3]};
+    u64x4_t s = {0};
+
+    for(uint32_t c=0; c<8; c++) {
+      u64x4_t k = (x >> (8*c)) & 0xff;
+      u64x4_t v = {tbl[c][k[0]], tbl[c][k[1]], tbl[c][k[2]], tbl[c][k[3]]};
+      s ^= v;
+    }
+
+    acc[i>>2] = s;
+  }
+
+  for(uint32_t i=0; i<64; i+=4) {
+    r->r[i  ] = acc[i>>2][0];
+    r->r[i+1] = acc[i>>2][1];
+    r->r[i+2] = acc[i>>2][2];
+    r->r[i+3] = acc[i>>2][3];
+  }
+}
+
+// r = M^n (r can alias m)
+static void vprng_gf2_pow(vprng_gf2_mat_t* r, const vprng_gf2_mat_t* m, uint64_t n)
+{
+  vprng_gf2_mat_t s = *m;
+
+  vprng_gf2_identity(r);
+
+  while (n != 0) {
+    if (n & 1) vprng_gf2_mul(r,r,&s);
+    n >>= 1;
+    if (n) vprng_gf2_mul(&s,&s,&s);
+  }
+}
+
+// rank by gaussian elimination
+static uint32_t vprng_gf2_rank(const vprng_gf2_mat_t* m)
+{
+  vprng_gf2_mat_t t = *m;
+  uint32_t        r = 0;
+
+  for(uint32_t c=0; c<64 && r<64; c++) {
+    uint64_t b = UINT64_C(1) << c;
+    uint32_t p = r;
+
+    while(p < 64 && !(t.r[p] & b)) p++;
+
+    if (p == 64) continue;
+
+    uint64_t row = t.r[p]; t.r[p] = t.r[r]; t.r[r] = row;
+
+    for(uint32_t i=0; i<64; i++)
+      if (i != r && (t.r[i] & b)) t.r[i] ^= row;
+
+    r++;
+  }
+  return r;
+}
+
+// builds the table of M^(2^k)
+static void vprng_gf2_jump_init(vprng_gf2_jump_t* j, const vprng_gf2_mat_t* m)
+{
+  vprng_gf2_mat_t s = *m;
+
+  for(uint32_t k=0; k<64; k++) {
+    j->t[k] = s;
+    vprng_gf2_transpose(j->t+k);
+    vprng_gf2_mul(&s,&s,&s);
+  }
+}
+
+// M^n x for each lane of 'x'
+static inline u64x4_t vprng_gf2_jump_x4(const vprng_gf2_jump_t* j, u64x4_t x, uint64_t n)
+{
+  while (n != 0) {
+    x  = vprng_gf2_apply_t_x4(j->t + __builtin_ctzll(n), x);
+    n &= n-1;
+  }
+  return x;
+}
+
+// M^n x
+static inline uint64_t vprng_gf2_jump(const vprng_gf2_jump_t* j, uint64_t x, uint64_t n)
+{
+  return vprng_gf2_jump_x4(j, vprng_splat_u64(x), n)[0];
+}
@@ -0,0 +1,245 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Random matrices for sketching and random projections (JL transforms).
+// Entries (f32 or f64) are one of:
+//
+// * VPRNG_MATRIX_GAUSSIAN:   normal with standard deviation 'scale'
+//                            (Box-Muller on lane pairs)
+// * VPRNG_MATRIX_RADEMACHER: +/-scale each with probability 1/2
+// * VPRNG_MATRIX_ACHLIOPTAS: sqrt(3)*scale*{+1,0,-1} with probabilities
+//                            {1/6,2/3,1/6} (sparse)
+//
+// The matrix is logically split into tiles of VPRNG_MATRIX_TILE_ROWS
+// by VPRNG_MATRIX_TILE_COLS (defaults are 64x64: 16K/32K bytes). Tile
+// (i,j) is generated from position base + t*s where t = i*(tiles per
+// row)+j and 's' is the number of steps per tile (vprng_pos_set). So
+// any tile can be regenerated on demand instead of stored. Within a
+// tile each step produces L (8 for f32, 4 for f64) consecutive entries
+// of a tile row. Values don't depend on the storage layout (row or
+// column major) nor the order tiles are generated. f32 and f64 matrices
+// are different. Partial tiles at the edges are the leading part of a
+// full tile.
+//
+// Requires positions (not vprng_aes).
+
+#pragma once
+
+#include "vprng.h"
+
+#if defined(VPRNG_STATE_EXTERNAL) && !defined(VPRNG_POS_EXTERNAL)
+#error "vprng_matrix.h: variant not supported"
+#endif
+
+#ifndef VPRNG_MATRIX_TILE_ROWS
+#define VPRNG_MATRIX_TILE_ROWS 64
+#endif
+
+#ifndef VPRNG_MATRIX_TILE_COLS
+#define VPRNG_MATRIX_TILE_COLS 64
+#endif
+
+static_assert((VPRNG_MATRIX_TILE_COLS & 7) == 0, "vprng_matrix: tile columns must be a multiple of 8");
+
+#define VPRNG_MATRIX_GAUSSIAN   0
+#define VPRNG_MATRIX_RADEMACHER 1
+#define VPRNG_MATRIX_ACHLIOPTAS 2
+
+#define VPRNG_MATRIX_ROW_MAJOR  0
+#define VPRNG_MATRIX_COL_MAJOR  1
+
+typedef struct {
+  vprng_t  prng;     // generator at 'base' (not modified)
+  uint64_t base;     // position of tile (0,0)
+  size_t   rows;
+  size_t   cols;
+  size_t   tiles;    // tiles per row of tiles
+  uint32_t dist;
+  double   scale;
+} vprng_matrix_t;
+
+// rows x cols matrix using 'prng' from its current position
+static inline void vprng_matrix_init(vprng_matrix_t* m, const vprng_t* prng,
+				     size_t rows, size_t cols, uint32_t dist, double scale)
+{
+  m->prng  = *prng;
+  m->base  = vprng_pos_get(&m->prng);
+  m->rows  = rows;
+  m->cols  = cols;
+  m->tiles = (cols + VPRNG_MATRIX_TILE_COLS-1)/VPRNG_MATRIX_TILE_COLS;
+  m->dist  = dist;
+  m->scale = scale;
+}
+
+// number of tiles in each direction
+static inline size_t vprng_matrix_tile_rows(const vprng_matrix_t* m)
+{
+  return (m->rows + VPRNG_MATRIX_TILE_ROWS-1)/VPRNG_MATRIX_TILE_ROWS;
+}
+
+static inline size_t vprng_matrix_tile_cols(const vprng_matrix_t* m)
+{
+  return m->tiles;
+}
+
+
+//*******************************************************************
+// entry transforms: one vector step to L entries
+
+#define VPRNG_MATRIX_TWO_PI 6.283185307179586476925286766559
+
+static inline f32x8_t vprng_matrix_gauss_f32(u32x8_t u, float s)
+{
+  f32x8_t r;
+
+  for(uint32_t i=0; i<8; i+=2) {
+    float a = (float)((u[i  ] >> 8)+1) * 0x1.0p-24f;   // (0,1]
+    float t = (float)( u[i+1] >> 8   ) * (0x1.0p-24f*(float)VPRNG_MATRIX_TWO_PI);
+    float d = s*sqrtf(-2.f*logf(a));
+
+    r[i  ] = d*cosf(t);
+    r[i+1] = d*sinf(t);
+  }
+  return r;
+}
+
+static inline f64x4_t vprng_matrix_gauss_f64(u64x4_t u, double s)
+{
+  f64x4_t r;
+
+  for(uint32_t i=0; i<4; i+=2) {
+    double a = (double)((u[i  ] >> 11)+1) * 0x1.0p-53;
+    double t = (double)( u[i+1] >> 11   ) * (0x1.0p-53*VPRNG_MATRIX_TWO_PI);
+    double d = s*sqrt(-2.0*log(a));
+
+    r[i  ] = d*cos(t);
+    r[i+1] = d*sin(t);
+  }
+  return r;
+}
+
+// sign from the top bit of each lane
+static inline f32x8_t vprng_matrix_rademacher_f32(u32x8_t u, float s)
+{
+  uint32_t b; memcpy(&b, &s, 4);
+  return vprng_cast_f32((u & UINT32_C(0x80000000)) | b);
+}
+
+static inline f64x4_t vprng_matrix_rademacher_f64(u64x4_t u, double s)
+{
+  uint64_t b; memcpy(&b, &s, 8);
+  return vprng_cast_f64((u & UINT64_C(0x8000000000000000)) | b);
+}
+
+// u < ceil(2^w/6) : +, u >= 2^w - ceil(2^w/6) : -, otherwise zero
+static inline f32x8_t vprng_matrix_achlioptas_f32(u32x8_t u, float s)
+{
+  const uint32_t t = UINT32_C(0x2aaaaaab);
+  uint32_t b; memcpy(&b, &s, 4);
+
+  u32x8_t p = (u32x8_t)(u <  t);
+  u32x8_t n = (u32x8_t)(u >= (uint32_t)-t);
+
+  return vprng_cast_f32(((p|n) & b) | (n & UINT32_C(0x80000000)));
+}
+
+static inline f64x4_t vprng_matrix_achlioptas_f64(u64x4_t u, double s)
+{
+  const uint64_t t = UINT64_C(0x2aaaaaaaaaaaaaab);
+  uint64_t b; memcpy(&b, &s, 8);
+
+  u64x4_t p = (u64x4_t)(u <  t);
+  u64x4_t n = (u64x4_t)(u >= (uint64_t)-t);
+
+  return vprng_cast_f64(((p|n) & b) | (n & UINT64_C(0x8000000000000000)));
+}
+
+static inline f32x8_t vprng_matrix_f32x8(const vprng_matrix_t* m, vprng_t* prng)
+{
+  u32x8_t u = vprng_u32x8(prng);
+
+  switch(m->dist) {
+    case VPRNG_MATRIX_RADEMACHER: return vprng_matrix_rademacher_f32(u, (float)m->scale);
+    case VPRNG_MATRIX_ACHLIOPTAS: return vprng_matrix_achlioptas_f32(u, (float)(m->scale*sqrt(3.0)));
+    default:                      return vprng_matrix_gauss_f32(u, (float)m->scale);
+  }
+}
+
+static inline f64x4_t vprng_matrix_f64x4(const vprng_matrix_t* m, vprng_t* prng)
+{
+  u64x4_t u = vprng_u64x4(prng);
+
+  switch(m->dist) {
+    case VPRNG_MATRIX_RADEMACHER: return vprng_matrix_rademacher_f64(u, m->scale);
+    case VPRNG_MATRIX_ACHLIOPTAS: return vprng_matrix_achlioptas_f64(u, m->scale*sqrt(3.0));
+    default:                      return vprng_matrix_gauss_f64(u, m->scale);
+  }
+}
+
+
+//*******************************************************************
+// vprng_matrix_tile_{f32,f64}: generates tile (i,j) to 'dst' (which
+// is the element (0,0) of the tile) with leading dimension 'ld' and
+// 'layout'. Writing to a tile sized buffer is: ld = tile rows/cols
+// vprng_matrix_fill_{f32,f64}: the full matrix. 'm' is read only so
+// threads can generate tiles of the same matrix concurrently.
+//
+// S: suffix, T: element type, L: lanes, V: vector type
+
+#define VPRNG_MATRIX_DEFINE(S,T,L,V)					\
+									\
+static void vprng_matrix_tile_##S(const vprng_matrix_t* m, size_t i, size_t j, \
+				  T* dst, size_t ld, uint32_t layout)	\
+{									\
+  vprng_t        g  = m->prng;						\
+  const uint64_t s  = VPRNG_MATRIX_TILE_ROWS*VPRNG_MATRIX_TILE_COLS/L;	\
+  size_t         r0 = i*VPRNG_MATRIX_TILE_ROWS;				\
+  size_t         c0 = j*VPRNG_MATRIX_TILE_COLS;				\
+  size_t         nr = m->rows - r0;					\
+  size_t         nc = m->cols - c0;					\
+									\
+  nr = (nr < VPRNG_MATRIX_TILE_ROWS) ? nr : VPRNG_MATRIX_TILE_ROWS;	\
+  nc = (nc < VPRNG_MATRIX_TILE_COLS) ? nc : VPRNG_MATRIX_TILE_COLS;	\
+									\
+  vprng_pos_set(&g, m->base + (i*m->tiles+j)*s);			\
+									\
+  for(size_t r=0; r<nr; r++) {						\
+    for(size_t c=0; c<VPRNG_MATRIX_TILE_COLS; c+=L) {			\
+      V v = vprng_matrix_##S##x##L(m, &g);				\
+									\
+      if (c >= nc) continue;						\
+									\
+      size_t n = (nc-c < L) ? nc-c : L;					\
+									\
+      if (layout == VPRNG_MATRIX_ROW_MAJOR) {				\
+	T* d = dst + r*ld + c;						\
+	if (n == L) memcpy(d, &v, sizeof(V));				\
+	else for(size_t k=0; k<n; k++) d[k] = v[k];			\
+      }									\
+      else {								\
+	T* d = dst + c*ld + r;						\
+	for(size_t k=0; k<n; k++) d[k*ld] = v[k];			\
+      }									\
+    }									\
+  }									\
+}									\
+									\
+static void vprng_matrix_fill_##S(const vprng_matrix_t* m, T* dst, size_t ld, uint32_t layout) \
+{									\
+  size_t tr = vprng_matrix_tile_rows(m);				\
+									\
+  for(size_t i=0; i<tr; i++) {						\
+    for(size_t j=0; j<m->tiles; j++) {					\
+      size_t r = i*VPRNG_MATRIX_TILE_ROWS;				\
+      size_t c = j*VPRNG_MATRIX_TILE_COLS;				\
+      size_t o = (layout == VPRNG_MATRIX_ROW_MAJOR) ? r*ld+c : c*ld+r;	\
+									\
+      vprng_matrix_tile_##S(m, i, j, dst+o, ld, layout);		\
+    }									\
+  }									\
+}
+
+VPRNG_MATRIX_DEFINE(f32, float,  8, f32x8_t)
+VPRNG_MATRIX_DEFINE(f64, double, 4, f64x4_t)
+
+#undef VPRNG_MATRIX_DEFINE
@@ -0,0 +1,138 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Memoryless random permutation of [0,n): visit an index space in
+// random order with O(1) memory instead of a Fisher-Yates array.
+//
+// A keyed bijection 'f' on [0,2^k) (2^k the smallest power of two
+// >= n) is built from the same structure as the bit finalizer on a
+// masked width. Each round is:
+//
+//   x = (x + key) & mask      (add round key)
+//   x ^= x >> s               (xorshift: s = ceil(k/2))
+//   x = (x * m)   & mask      (odd multiply)
+//
+// followed by a final xorshift. All are bijections of k-bit values.
+// Cycle walking restricts to [0,n): f is reapplied while the result
+// is >= n which (since 2^k < 2n) takes fewer than two applications
+// on average. The batch form evaluates four indices per step (lanes
+// which are done idle while others walk).
+//
+// This is a shuffle for sampling/visiting, not a cryptographic
+// permutation.
+
+#pragma once
+
+#include "vprng.h"
+
+#ifndef VPRNG_PERM_ROUNDS
+#define VPRNG_PERM_ROUNDS 4
+#endif
+
+static_assert((VPRNG_PERM_ROUNDS & 1) == 0, "vprng_perm: VPRNG_PERM_ROUNDS must be even");
+
+typedef struct {
+  uint64_t n;
+  uint64_t mask;
+  uint32_t shift;
+  uint64_t key[VPRNG_PERM_ROUNDS];
+  uint64_t mul[VPRNG_PERM_ROUNDS];
+} vprng_perm_t;
+
+// a random permutation of [0,n) (n > 0) with keys drawn from 'prng'
+static inline void vprng_perm_init(vprng_perm_t* perm, vprng_t* prng, uint64_t n)
+{
+  uint32_t k = (n > 1) ? 64-(uint32_t)__builtin_clzll(n-1) : 0;
+
+  perm->n     = n;
+  perm->mask  = (k < 64) ? (UINT64_C(1) << k)-1 : ~UINT64_C(0);
+  perm->shift = (k+1) >> 1;
+
+  for(uint32_t i=0; i<VPRNG_PERM_ROUNDS; i+=2) {
+    u64x4_t r = vprng_u64x4(prng);
+
+    perm->key[i  ] = r[0];
+    perm->mul[i  ] = r[1] | 1;
+    perm->key[i+1] = r[2];
+    perm->mul[i+1] = r[3] | 1;
+  }
+}
+
+// f applied to each lane
+static inline u64x4_t vprng_perm_f(const vprng_perm_t* perm, u64x4_t x)
+{
+  const uint64_t mask = perm->mask;
+  const uint32_t s    = perm->shift;
+
+  for(uint32_t i=0; i<VPRNG_PERM_ROUNDS; i++) {
+    x  = (x + perm->key[i]) & mask;
+    x ^= x >> s;
+    x  = (x * perm->mul[i]) & mask;
+  }
+
+  return x ^ (x >> s);
+}
+
+// cycle walk lanes of 'x' which are out of range
+static inline u64x4_t vprng_perm_walk(const vprng_perm_t* perm, u64x4_t x)
+{
+  u64x4_t w = (u64x4_t)(x >= perm->n);
+
+  while ((w[0]|w[1]|w[2]|w[3]) != 0) {
+    x = (x & ~w) | (vprng_perm_f(perm, x) & w);
+    w = (u64x4_t)(x >= perm->n);
+  }
+
+  return x;
+}
+
+// element 'i' (of each lane) of the permutation (i < n)
+static inline u64x4_t vprng_perm_x4(const vprng_perm_t* perm, u64x4_t i)
+{
+  return vprng_perm_walk(perm, vprng_perm_f(perm, i));
+}
+
+static inline uint64_t vprng_perm_at(const vprng_perm_t* perm, uint64_t i)
+{
+  return vprng_perm_x4(perm, vprng_splat_u64(i))[0];
+}
+
+// out[j] = perm(start+j) for j < count. The main loop applies 'f' to
+// four independent vectors to hide the multiply latency.
+static inline void vprng_perm_batch(const vprng_perm_t* perm, uint64_t start, size_t count,
+				    uint64_t out[static count])
+{
+  u64x4_t i = vprng_splat_u64(start) + (u64x4_t){0,1,2,3};
+  size_t  j = 0;
+
+  // local copy: stores to 'out' could otherwise alias the keys
+  vprng_perm_t p = *perm;
+
+  for(; j+16 <= count; j+=16, i+=16) {
+    u64x4_t x[4] = {i, i+4, i+8, i+12};
+
+    for(uint32_t r=0; r<VPRNG_PERM_ROUNDS; r++) {
+      for(uint32_t k=0; k<4; k++) {
+	x[k]  = (x[k] + p.key[r]) & p.mask;
+	x[k] ^= x[k] >> p.shift;
+	x[k]  = (x[k] * p.mul[r]) & p.mask;
+      }
+    }
+
+    for(uint32_t k=0; k<4; k++) {
+      x[k] = vprng_perm_walk(&p, x[k] ^ (x[k] >> p.shift));
+      memcpy(out+j+4*k, x+k, sizeof(u64x4_t));
+    }
+  }
+
+  for(; j+4 <= count; j+=4, i+=4) {
+    u64x4_t x = vprng_perm_x4(perm, i);
+    memcpy(out+j, &x, sizeof(x));
+  }
+
+  if (j < count) {
+    // unused lanes are clamped to a valid index
+    u64x4_t x = vprng_perm_x4(perm, i & (u64x4_t)(i < perm->n));
+    memcpy(out+j, &x, (count-j)*sizeof(uint64_t));
+  }
+}
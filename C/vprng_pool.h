@@ -0,0 +1,209 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Structure of arrays pool of generators for (very) many independent
+// streams. States, additive constants and F2 states (if combined)
+// are separate 32 byte aligned arrays and the batch kernels advance
+// a contiguous range of generators per call.
+//
+// * VPRNG_POOL_SHARED:   all generators share a single additive
+//   constant (halves the memory of the base generator). generator 'i'
+//   starts at position i*2^s where 2^s is the largest power of two
+//   spacing that fits 'n' streams in 2^64 (so each has at least 2^s
+//   outputs before running into the next). Same idea as VPRNG_HIGHLANDER.
+// * VPRNG_POOL_COMBINED: also holds F2 states (cvprng_t). Use the
+//   cvprng_pool_* kernels.
+//
+// Not supported: VPRNG_HIGHLANDER and variants with per generator
+// data (VPRNG_INIT_EXTRA). Shared mode also requires stream positions
+// (not an external state without VPRNG_POS_EXTERNAL: vprng_aes) and
+// vprng_pool_init fails if it's requested for those.
+
+#pragma once
+
+#include <stdlib.h>
+
+#include "vprng.h"
+
+#if defined(VPRNG_HIGHLANDER) || defined(VPRNG_INIT_EXTRA)
+#error "vprng_pool.h: variant not supported"
+#endif
+
+#define VPRNG_POOL_SHARED   1
+#define VPRNG_POOL_COMBINED 2
+
+typedef struct {
+  u64x4_t* state;    // n
+  u64x4_t* inc;      // n or 1 (shared)
+  u64x4_t* f2;       // n*VPRNG_STATE_WORDS (combined) or NULL
+  size_t   n;
+  uint32_t flags;
+  uint32_t shift;    // shared: log2 of position spacing
+} vprng_pool_t;
+
+static inline size_t vprng_pool_inc_index(const vprng_pool_t* pool, size_t i)
+{
+  return (pool->flags & VPRNG_POOL_SHARED) ? 0 : i;
+}
+
+// copy out/in generator 'i' as a standard generator
+static inline void vprng_pool_get(const vprng_pool_t* pool, size_t i, vprng_t* prng)
+{
+  prng->state = pool->state[i];
+  prng->inc   = pool->inc[vprng_pool_inc_index(pool,i)];
+}
+
+// (in shared mode the additive constant is not modified)
+static inline void vprng_pool_set(vprng_pool_t* pool, size_t i, const vprng_t* prng)
+{
+  pool->state[i] = prng->state;
+
+  if (!(pool->flags & VPRNG_POOL_SHARED)) pool->inc[i] = prng->inc;
+}
+
+static inline void cvprng_pool_get(const vprng_pool_t* pool, size_t i, cvprng_t* prng)
+{
+  vprng_pool_get(pool, i, &prng->base);
+  memcpy(prng->f2, pool->f2 + i*VPRNG_STATE_WORDS, sizeof(prng->f2));
+}
+
+static inline void cvprng_pool_set(vprng_pool_t* pool, size_t i, const cvprng_t* prng)
+{
+  vprng_pool_set(pool, i, &prng->base);
+  memcpy(pool->f2 + i*VPRNG_STATE_WORDS, prng->f2, sizeof(prng->f2));
+}
+
+static inline void vprng_pool_free(vprng_pool_t* pool)
+{
+  free(pool->state);
+  free(pool->inc);
+  free(pool->f2);
+  memset(pool, 0, sizeof(vprng_pool_t));
+}
+
+static inline u64x4_t* vprng_pool_alloc(size_t n)
+{
+  return (u64x4_t*)aligned_alloc(sizeof(u64x4_t), n*sizeof(u64x4_t));
+}
+
+// allocates and initializes 'n' generators. Non-shared uses the
+// same constants as 'n' calls of vprng_init (via vprng_init_n).
+// returns 0 on success (fails for shared mode without positions)
+static int vprng_pool_init(vprng_pool_t* pool, size_t n, uint32_t flags)
+{
+  const int shared   = (flags & VPRNG_POOL_SHARED)   != 0;
+  const int combined = (flags & VPRNG_POOL_COMBINED) != 0;
+
+  memset(pool, 0, sizeof(vprng_pool_t));
+
+#if defined(VPRNG_STATE_EXTERNAL) && !defined(VPRNG_POS_EXTERNAL)
+  // vprng_pos_set isn't a stream position here
+  if (shared) return -1;
+#endif
+
+  pool->n     = n;
+  pool->flags = flags;
+  pool->state = vprng_pool_alloc(n);
+  pool->inc   = vprng_pool_alloc(shared ? 1 : n);
+  pool->f2    = combined ? vprng_pool_alloc(n*VPRNG_STATE_WORDS) : NULL;
+
+  if (!pool->state || !pool->inc || (combined && !pool->f2)) {
+    vprng_pool_free(pool);
+    return -1;
+  }
+
+  if (!shared) {
+    enum { B = 64 };
+    vprng_t t[B];
+
+    for(size_t i=0; i<n; i+=B) {
+      size_t m = (n-i < B) ? n-i : B;
+
+      vprng_init_n(t, m);
+
+      for(size_t j=0; j<m; j++) vprng_pool_set(pool, i+j, t+j);
+    }
+
+    if (combined) {
+      u64x4_t f2[VPRNG_STATE_WORDS];
+      cvprng_f2_init(f2);
+      for(size_t i=0; i<n; i++)
+	memcpy(pool->f2 + i*VPRNG_STATE_WORDS, f2, sizeof(f2));
+    }
+  }
+  else {
+    cvprng_t t;
+    uint32_t s = 64;
+
+    while (s > 0 && (n-1) >> (64-s)) s--;
+
+    s = (s < 64) ? s : 63;
+    pool->shift = s;
+
+    cvprng_init(&t);
+    pool->inc[0] = t.base.inc;
+
+    for(size_t i=0; i<n; i++) {
+      uint64_t pos = (uint64_t)i << s;
+
+      vprng_pos_set(&t.base, pos);
+      pool->state[i] = t.base.state;
+
+      if (combined) {
+	// F2 state: step from the previous position
+	if (i != 0) cvprng_f2_jump(t.f2, UINT64_C(1) << s);
+	memcpy(pool->f2 + i*VPRNG_STATE_WORDS, t.f2, sizeof(t.f2));
+      }
+    }
+  }
+
+  return 0;
+}
+
+
+// batch kernels: out[j] is the next output of generator first+j
+// which is advanced by one
+
+static inline void vprng_pool_step_u32(vprng_pool_t* pool, size_t first, size_t count,
+				       u32x8_t out[static count])
+{
+  u64x4_t* state = pool->state + first;
+
+  if (pool->flags & VPRNG_POOL_SHARED) {
+    vprng_t t = {.inc = pool->inc[0]};
+
+    for(size_t j=0; j<count; j++) {
+      t.state  = state[j];
+      out[j]   = vprng_u32x8(&t);
+      state[j] = t.state;
+    }
+  }
+  else {
+    u64x4_t* inc = pool->inc + first;
+
+    for(size_t j=0; j<count; j++) {
+      vprng_t t = {.state = state[j], .inc = inc[j]};
+      out[j]   = vprng_u32x8(&t);
+      state[j] = t.state;
+    }
+  }
+}
+
+static inline void cvprng_pool_step_u32(vprng_pool_t* pool, size_t first, size_t count,
+					u32x8_t out[static count])
+{
+  for(size_t j=0; j<count; j++) {
+    size_t   i  = first+j;
+    u64x4_t* f2 = pool->f2 + i*VPRNG_STATE_WORDS;
+    cvprng_t t;
+
+    t.base.state = pool->state[i];
+    t.base.inc   = pool->inc[vprng_pool_inc_index(pool,i)];
+    memcpy(t.f2, f2, sizeof(t.f2));
+
+    out[j] = cvprng_u32x8(&t);
+
+    pool->state[i] = t.base.state;
+    memcpy(f2, t.f2, sizeof(t.f2));
+  }
+}
@@ -0,0 +1,164 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Cross process generator id allocation (POSIX). The global id
+// counter (see vprng_global_id_bind) is placed in a named shared
+// memory segment or a memory mapped file so all processes which
+// open the same name reserve ids from the same counter (the same
+// lock-free atomics as threads) and get distinct generators with
+// no coordinator.
+//
+// * vprng_shm_open:  named POSIX shared memory (shm_open). Lives
+//   until unlinked (vprng_shm_unlink) or reboot.
+// * vprng_shm_file:  memory mapped file. Persists across reboots.
+//
+// Crash safety: the counter is only ever atomically advanced in
+// place so a process dying at any point can at worst leak the ids
+// it had reserved (never reuse). vprng_shm_sync flushes a file
+// backed counter to storage (for surviving power loss).
+//
+// The process which creates the segment sets the counter to
+// VPRNG_SHM_ID_INIT (default 1: same as the process local counter).
+// While a counter is bound vprng_global_id_set is ignored: workers
+// which set the id at startup (such as vprng_global_id_set(1)) would
+// otherwise reset the counter for all processes and reuse ids.
+//
+// Not supported by vpcg32 (VPRNG_ADDITIVE_CONSTANT_EXTERN) which has
+// its own 32-bit counter.
+//
+// usage (each worker):
+//   vprng_shm_t shm;
+//   if (vprng_shm_open(&shm, "/myapp_vprng") != 0) { ...error... }
+//   ... vprng_init, vprng_init_n, leases, etc ...
+//   vprng_shm_close(&shm);
+
+#pragma once
+
+#if defined(_WIN32)
+#error "vprng_shm.h: POSIX only"
+#endif
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "vprng.h"
+
+#if defined(VPRNG_ADDITIVE_CONSTANT_EXTERN)
+#error "vprng_shm.h: variant not supported (no vprng_global_id_bind)"
+#endif
+
+#ifndef VPRNG_SHM_ID_INIT
+#define VPRNG_SHM_ID_INIT 1
+#endif
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "vprng_shm: requires address free 64-bit atomics");
+
+// segment layout (version checked by 'magic')
+typedef struct {
+  _Atomic uint64_t magic;
+  _Atomic uint64_t id;
+} vprng_shm_seg_t;
+
+typedef struct {
+  vprng_shm_seg_t* seg;
+  int              fd;
+} vprng_shm_t;
+
+#define VPRNG_SHM_MAGIC UINT64_C(0x7670726e67696401)
+#define VPRNG_SHM_INIT  UINT64_C(0x7670726e67696400)   // creator initializing
+
+// maps the open file descriptor 'fd' and binds the counter.
+// returns 0 on success (otherwise closes 'fd')
+static inline int vprng_shm_map(vprng_shm_t* shm, int fd)
+{
+  struct stat st;
+  uint64_t    e = 0;
+  void*       p;
+
+  shm->seg = NULL;
+  shm->fd  = fd;
+
+  if (fd < 0) return -1;
+
+  // any opener grows to size: racing creators is fine since
+  // the added bytes are zero.
+  if (fstat(fd, &st) != 0) goto fail;
+
+  if ((size_t)st.st_size < sizeof(vprng_shm_seg_t))
+    if (ftruncate(fd, (off_t)sizeof(vprng_shm_seg_t)) != 0) goto fail;
+
+  p = mmap(NULL, sizeof(vprng_shm_seg_t), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+
+  if (p == MAP_FAILED) goto fail;
+
+  shm->seg = (vprng_shm_seg_t*)p;
+
+  // first to see a fresh segment sets the initial id and then tags
+  // it. others wait out the (two store) initialization. reject
+  // anything else
+  if (atomic_compare_exchange_strong(&shm->seg->magic, &e, VPRNG_SHM_INIT)) {
+    atomic_store(&shm->seg->id, VPRNG_SHM_ID_INIT);
+    atomic_store(&shm->seg->magic, VPRNG_SHM_MAGIC);
+    e = VPRNG_SHM_MAGIC;
+  }
+
+  while (e == VPRNG_SHM_INIT) e = atomic_load(&shm->seg->magic);
+
+  if (e != VPRNG_SHM_MAGIC) {
+    munmap(p, sizeof(vprng_shm_seg_t));
+    shm->seg = NULL;
+    goto fail;
+  }
+
+  vprng_global_id_bind(&shm->seg->id);
+
+  return 0;
+
+ fail:
+  close(fd);
+  shm->fd = -1;
+  return -1;
+}
+
+// opens (creating if needed) the named shared memory segment 'name'
+// (leading '/' as per shm_open) and binds the global id counter
+static inline int vprng_shm_open(vprng_shm_t* shm, const char* name)
+{
+  return vprng_shm_map(shm, shm_open(name, O_RDWR|O_CREAT, 0666));
+}
+
+// same but with the memory mapped file 'path'
+static inline int vprng_shm_file(vprng_shm_t* shm, const char* path)
+{
+  return vprng_shm_map(shm, open(path, O_RDWR|O_CREAT, 0666));
+}
+
+// flushes the counter to storage (file backed)
+static inline int vprng_shm_sync(vprng_shm_t* shm)
+{
+  return msync(shm->seg, sizeof(vprng_shm_seg_t), MS_SYNC);
+}
+
+// unbinds (back to the process local counter) and unmaps. Any
+// thread leases should be released before.
+static inline void vprng_shm_close(vprng_shm_t* shm)
+{
+  if (shm->seg == NULL) return;
+
+  vprng_global_id_bind(NULL);
+  munmap(shm->seg, sizeof(vprng_shm_seg_t));
+  close(shm->fd);
+
+  shm->seg = NULL;
+  shm->fd  = -1;
+}
+
+// removes the named segment (existing mappings remain valid)
+static inline int vprng_shm_unlink(const char* name)
+{
+  return shm_unlink(name);
+}
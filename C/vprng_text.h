@@ -0,0 +1,135 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Random bytes and random ASCII strings (payloads, identifiers, tokens)
+// converted directly from generator output a vector at a time:
+//
+// * vprng_text_bytes:     raw bytes (32 per step)
+// * vprng_text_hex:       [0-9a-f]          (64 per step: both nibbles)
+// * vprng_text_base64url: [A-Za-z0-9-_]     (32 per step: 6 of each 8 bits)
+// * vprng_text_alphabet:  any alphabet of 1-256 symbols. unbiased by
+//   multiply/shift with rejection (Lemire) on 16-bit chunks. the
+//   rejection rate is (2^16 mod m)/2^16 < 0.4% (none for powers of two)
+//
+// Hex uses a 16 entry shuffle LUT (AVX2 pshufb) and base64url a
+// small compare/offset sequence on byte vectors. None of these write
+// a terminating NUL and a partially used last step is discarded.
+//
+// Not for secrets: this is not a cryptographic generator.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "vprng.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if !defined(SFH_SIMD_256)
+typedef uint8_t u8x32_t __attribute__ ((vector_size(32)));
+typedef int8_t  i8x32_t __attribute__ ((vector_size(32)));
+#endif
+
+static inline u8x32_t vprng_u8x32(vprng_t* prng)
+{
+  u32x8_t v = vprng_u32x8(prng); u8x32_t r; memcpy(&r,&v,32); return r;
+}
+
+// copies 'm' (<=32) bytes of 'v' (full vector is a single store)
+static inline void vprng_text_store(char* dst, u8x32_t v, size_t m)
+{
+  if (m == 32) memcpy(dst, &v, 32); else memcpy(dst, &v, m);
+}
+
+// nibbles (0-15) to [0-9a-f]
+static inline u8x32_t vprng_text_hex_map(u8x32_t n)
+{
+#if defined(__AVX2__)
+  const __m256i lut = _mm256_setr_epi8('0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f',
+				       '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f');
+  __m256i x; memcpy(&x, &n, 32);
+  x = _mm256_shuffle_epi8(lut, x);
+  memcpy(&n, &x, 32);
+  return n;
+#else
+  return n + '0' + ((u8x32_t)(n > 9) & ('a'-'0'-10));
+#endif
+}
+
+// 6-bit values to [A-Za-z0-9-_]: base offset + adjust at each range boundary
+static inline u8x32_t vprng_text_base64url_map(u8x32_t v)
+{
+  u8x32_t c = v + 'A';
+
+  c += (u8x32_t)(v > 25) & (uint8_t)(('a'-26)-'A');
+  c += (u8x32_t)(v > 51) & (uint8_t)(('0'-52)-('a'-26));
+  c += (u8x32_t)(v > 61) & (uint8_t)(('-'-62)-('0'-52));
+  c += (u8x32_t)(v > 62) & (uint8_t)(('_'-63)-('-'-62));
+
+  return c;
+}
+
+static inline void vprng_text_bytes(vprng_t* prng, void* dst, size_t n)
+{
+  char* d = (char*)dst;
+
+  for(size_t i=0; i<n; i+=32) {
+    size_t m = (n-i < 32) ? n-i : 32;
+    vprng_text_store(d+i, vprng_u8x32(prng), m);
+  }
+}
+
+static inline void vprng_text_hex(vprng_t* prng, char* dst, size_t n)
+{
+  for(size_t i=0; i<n; i+=64) {
+    u8x32_t b  = vprng_u8x32(prng);
+    u8x32_t lo = vprng_text_hex_map(b & 0xf);
+    u8x32_t hi = vprng_text_hex_map(b >> 4);
+    size_t  m  = n-i;
+
+    if (m >= 64) {
+      vprng_text_store(dst+i,    lo, 32);
+      vprng_text_store(dst+i+32, hi, 32);
+    }
+    else {
+      vprng_text_store(dst+i, lo, (m < 32) ? m : 32);
+      if (m > 32) vprng_text_store(dst+i+32, hi, m-32);
+    }
+  }
+}
+
+static inline void vprng_text_base64url(vprng_t* prng, char* dst, size_t n)
+{
+  for(size_t i=0; i<n; i+=32) {
+    size_t m = (n-i < 32) ? n-i : 32;
+    vprng_text_store(dst+i, vprng_text_base64url_map(vprng_u8x32(prng) & 0x3f), m);
+  }
+}
+
+// 'm' symbols (1-256) of 'alphabet'
+static inline void vprng_text_alphabet(vprng_t* prng, char* dst, size_t n,
+				       const char* alphabet, uint32_t m)
+{
+  const uint32_t t = (65536u % m);   // reject if low 16 bits of product < t
+  size_t         j = 0;
+
+  while (j < n) {
+    u32x8_t u  = vprng_u32x8(prng);
+    u32x8_t p0 = (u & 0xffff)*m;
+    u32x8_t p1 = (u >> 16)*m;
+    u32x8_t a0 = (u32x8_t)((p0 & 0xffff) >= t);
+    u32x8_t a1 = (u32x8_t)((p1 & 0xffff) >= t);
+
+    p0 >>= 16;
+    p1 >>= 16;
+
+    // compress accepted (unconditional store, conditional advance)
+    for(uint32_t k=0; k<8 && j<n; k++) {
+      dst[j] = alphabet[p0[k]]; j += a0[k] & 1;
+      if (j == n) break;
+      dst[j] = alphabet[p1[k]]; j += a1[k] & 1;
+    }
+  }
+}
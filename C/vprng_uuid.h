@@ -0,0 +1,107 @@
+// Marc B. Reynolds, 2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Bulk UUID generation (RFC 9562): two UUIDs per generator step. The
+// random bits are the 32 byte output as is (each 128-bit half is a
+// UUID) and the fixed fields are merged with AND/OR byte masks.
+//
+// * vprng_uuid_v4_fill: version 4 (122 random bits)
+// * vprng_uuid_v7_fill: version 7 with the caller supplied unix time
+//   in milliseconds as the 48-bit big endian prefix (74 random bits).
+//   Ordering within a millisecond is random (no counter).
+// * vprng_uuid_format:  8-4-4-4-12 lowercase hex text (36 chars, no NUL)
+//
+// Not for secrets: this is not a cryptographic generator.
+
+#pragma once
+
+#include "vprng_text.h"
+
+typedef struct { uint8_t b[16]; } vprng_uuid_t;
+
+typedef uint8_t  vprng_u8x16_t  __attribute__ ((vector_size(16)));
+typedef uint16_t vprng_u16x16_t __attribute__ ((vector_size(32)));
+
+// AND/OR masks for the version (byte 6 high nibble) and variant
+// (byte 8: 10xxxxxx) fields of both halves
+static const u8x32_t vprng_uuid_and =
+{
+  0xff,0xff,0xff,0xff, 0xff,0xff,0x0f,0xff, 0x3f,0xff,0xff,0xff, 0xff,0xff,0xff,0xff,
+  0xff,0xff,0xff,0xff, 0xff,0xff,0x0f,0xff, 0x3f,0xff,0xff,0xff, 0xff,0xff,0xff,0xff,
+};
+
+static const u8x32_t vprng_uuid_or =
+{
+  0,0,0,0, 0,0,0x40,0, 0x80,0,0,0, 0,0,0,0,
+  0,0,0,0, 0,0,0x40,0, 0x80,0,0,0, 0,0,0,0,
+};
+
+// stores two UUIDs (or just the first if n is 1)
+static inline void vprng_uuid_store(vprng_uuid_t* out, u8x32_t v, size_t n)
+{
+  if (n >= 2) memcpy(out, &v, 32); else memcpy(out, &v, 16);
+}
+
+static inline void vprng_uuid_fill(vprng_t* prng, vprng_uuid_t* out, size_t n,
+				   u8x32_t a, u8x32_t o)
+{
+  for(size_t i=0; i<n; i+=2)
+    vprng_uuid_store(out+i, (vprng_u8x32(prng) & a) | o, n-i);
+}
+
+static inline void vprng_uuid_v4_fill(vprng_t* prng, vprng_uuid_t* out, size_t n)
+{
+  vprng_uuid_fill(prng, out, n, vprng_uuid_and, vprng_uuid_or);
+}
+
+static inline void vprng_uuid_v7_fill(vprng_t* prng, vprng_uuid_t* out, size_t n, uint64_t ms)
+{
+  u8x32_t a = vprng_uuid_and;
+  u8x32_t o = vprng_uuid_or;
+
+  // version 7 and the timestamp bytes
+  o[6] = o[22] = 0x70;
+
+  for(uint32_t i=0; i<6; i++) {
+    uint8_t t = (uint8_t)(ms >> (40-8*i));
+    a[i] = a[i+16] = 0;
+    o[i] = o[i+16] = t;
+  }
+
+  vprng_uuid_fill(prng, out, n, a, o);
+}
+
+// text form of 'u' to 'dst'
+static inline void vprng_uuid_format(char dst[static 36], const vprng_uuid_t* u)
+{
+  vprng_u8x16_t b;
+  u8x32_t       n;
+  char          h[32];
+
+  // widen bytes to 16-bit and swap nibbles into place: the high
+  // nibble is the first (little endian: low) byte
+  memcpy(&b, u->b, 16);
+
+  vprng_u16x16_t w = __builtin_convertvector(b, vprng_u16x16_t);
+
+  w = (w >> 4) | ((w & 0xf) << 8);
+
+  memcpy(&n, &w, 32);
+  n = vprng_text_hex_map(n);
+  memcpy(h, &n, 32);
+
+  memcpy(dst,    h,    8); dst[ 8] = '-';
+  memcpy(dst+ 9, h+ 8, 4); dst[13] = '-';
+  memcpy(dst+14, h+12, 4); dst[18] = '-';
+  memcpy(dst+19, h+16, 4); dst[23] = '-';
+  memcpy(dst+24, h+20, 12);
+}
+
+// 'n' UUIDs as text: 37 chars each (36 + 'sep')
+static inline void vprng_uuid_format_n(char* dst, const vprng_uuid_t* u, size_t n, char sep)
+{
+  for(size_t i=0; i<n; i++, dst+=37) {
+    vprng_uuid_format(dst, u+i);
+    dst[36] = sep;
+  }
+}
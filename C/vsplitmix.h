@@ -24,30 +24,59 @@
 #pragma once
 
 #define VPRNG_NAME "vsplitmix"
+#define VPRNG_VARIANT_ID 3
 #define VPRNG_MIX_EXTERNAL
 
 #include "vprng.h"
 
-// MIX14: http://zimbry.blogspot.com/2011/09/better-bit-mixing-improving-on.html
+// MIX14 on all lanes (vprng_mix14)
 static inline u32x8_t vprng_mix(vprng_unused vprng_t* prng, u64x4_t x)
 {
-  x ^= x >> 30; x *= UINT64_C(0x4be98134a5976fd3);
-  x ^= x >> 29; x *= UINT64_C(0x3bc0993a5ad19a13);
-  x ^= x >> 31;
+  return vprng_cast_u32(vprng_mix14(x));
+}
 
-  return vprng_cast_u32(x);
+static inline u64x4_t vprng_unmix(vprng_unused vprng_t* prng, u32x8_t x)
+{
+  return vprng_mix14_inv(vprng_cast_u64(x));
 }
 
 
 //
 #if defined(VPRNG_SELF_TEST)
-//#define SELF_TEST
+#define SELF_TEST
+
+// scalar SplitMix64 (with the same additive constant and initial
+// state) as a reference. lane 'i' of result 'n' is the scalar
+// generator's 'n'th output.
+static uint64_t vsplitmix_ref(uint64_t x)
+{
+  x ^= x >> 30; x *= UINT64_C(0x4be98134a5976fd3);
+  x ^= x >> 29; x *= UINT64_C(0x3bc0993a5ad19a13);
+  x ^= x >> 31;
+  return x;
+}
 
 uint32_t self_test(void)
 {
-  printf("he's dead Jim\n");
+  test_name("scalar reference");
+
+  vprng_t  prng;
+  uint64_t s[4];
+
+  vprng_init(&prng);
+
+  for(uint32_t i=0; i<4; i++) s[i] = prng.state[i];
+
+  for(uint32_t n=0; n<0xffff; n++) {
+    u64x4_t v = vprng_u64x4(&prng);
 
-  return 0;
+    for(uint32_t i=0; i<4; i++) {
+      if (v[i] == vsplitmix_ref(s[i])) { s[i] += prng.inc[i]; continue; }
+      return test_fail();
+    }
+  }
+  
+  return test_pass();
 }
 
 #endif